@@ -0,0 +1,26 @@
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace benchmarks {
+
+    /**
+     * Run the function the given number of times and display the mean duration of a run
+     */
+    inline double benchmark(const std::string &name, const std::function<void()> &function, int runs = 5) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; i++) {
+            function();
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+        std::cout << name << ": " << milliseconds << " ms\n";
+        return milliseconds;
+    }
+
+} // namespace benchmarks
+
+#endif // BENCHMARKS_HPP
@@ -0,0 +1,8 @@
+#include "parser_benchmarks/parser_benchmarks.hpp"
+#include "tree_benchmarks/tree_benchmarks.hpp"
+
+int main() {
+    parserBenchmarks::parserBenchmarks();
+    treeBenchmarks::treeBenchmarks();
+    return 0;
+}
@@ -0,0 +1,347 @@
+#include "parser_benchmarks.hpp"
+
+namespace parserBenchmarks {
+
+    std::string blockWithDeclarations(int declarationsCount) {
+        std::string style = "label {\n";
+        for (int i = 0; i < declarationsCount; i++) {
+            style += "    padding: " + std::to_string(i % 100) + "px;\n";
+        }
+        return style + "}\n";
+    }
+
+    /**
+     * Building the childs of a node must take a time proportional to their number,
+     * so doubling the declarations of a block must only double the time to parse it
+     */
+    void benchmarkBlockDeclarations(const style::config::Config *config) {
+        for (int declarationsCount : {10000, 20000}) {
+            std::string style = blockWithDeclarations(declarationsCount);
+            style::TokenStream tokens = style::Lexer().lexeTokens(style, config);
+            benchmarks::benchmark("Parsing a block with " + std::to_string(declarationsCount) + " declarations",
+                                  [&tokens]() { delete style::Parser().parse(tokens); });
+            benchmarks::benchmark("Deserializing a block with " + std::to_string(declarationsCount) + " declarations", [&style, config]() {
+                int ruleNumber;
+                std::list<style::StyleDefinition *> *styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+                for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                    delete styleDefinition;
+                }
+                delete styleDefinitions;
+            });
+        }
+    }
+
+    std::string nestedBlocks(int blocksCount) {
+        std::string style;
+        for (int i = 0; i < blocksCount; i++) {
+            style += "label.c" + std::to_string(i) + ", button {\n    padding: 5px;\n    text-color: #fff;\n";
+            style += "    &:hover, span > .icon {\n        padding: (1px, 2px);\n";
+            style += "        .a {\n            text-color: #ff0000;\n        }\n    }\n}\n";
+        }
+        return style;
+    }
+
+    /**
+     * The single pass compilation must be faster than building, flattening and converting the tree of the style
+     */
+    void benchmarkCompilation(const style::config::Config *config) {
+        std::string style = nestedBlocks(2000);
+        for (bool compiled : {false, true}) {
+            std::string name = std::string(compiled ? "Compiling" : "Deserializing") + " 2000 blocks with nested blocks";
+            benchmarks::benchmark(name, [&style, config, compiled]() {
+                int ruleNumber;
+                std::list<style::StyleDefinition *> *styleDefinitions =
+                    compiled ? style::StyleDeserializer::compile(style, 0, &ruleNumber, config)
+                             : style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+                for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                    delete styleDefinition;
+                }
+                delete styleDefinitions;
+            });
+        }
+    }
+
+    /**
+     * Editing a value must only deserialize again the block containing it, whatever the size of the style
+     */
+    void benchmarkIncrementalEdit(const style::config::Config *config) {
+        for (int blocksCount : {1000, 2000}) {
+            style::IncrementalStyle style = style::IncrementalStyle(nestedBlocks(blocksCount), 0, config);
+            size_t position = style.style().find("5px", style.style().size() / 2);
+            benchmarks::benchmark("Editing a value in " + std::to_string(blocksCount) + " blocks with nested blocks",
+                                  [&style, position]() {
+                                      style.edit(position, 1, (style.style()[position] == '5') ? "6" : "5");
+                                      style.definitions();
+                                  },
+                                  100);
+        }
+    }
+
+    /**
+     * Adding or removing a rule at the start of the style must only compile again the first block, the rules numbers of the next blocks
+     * being shifted in place when the definitions are read
+     */
+    void benchmarkIncrementalEditAtStart(const style::config::Config *config) {
+        const std::string rule = "    padding: 1px;\n";
+        for (int blocksCount : {1000, 2000}) {
+            style::IncrementalStyle style = style::IncrementalStyle(nestedBlocks(blocksCount), 0, config);
+            size_t position = style.style().find('\n') + 1;
+            benchmarks::benchmark("Adding and removing a rule at the start of " + std::to_string(blocksCount) + " blocks with nested blocks",
+                                  [&style, &rule, position]() {
+                                      if (style.style().compare(position, rule.size(), rule) == 0) style.edit(position, rule.size(), "");
+                                      else style.edit(position, 0, rule);
+                                      style.definitions();
+                                  },
+                                  100);
+        }
+    }
+
+    /**
+     * Editing a block left unclosed must only deserialize again this block, the next ones can't close it
+     */
+    void benchmarkIncrementalEditInUnclosedBlock(const style::config::Config *config) {
+        for (int blocksCount : {1000, 2000}) {
+            style::IncrementalStyle style = style::IncrementalStyle(nestedBlocks(blocksCount), 0, config);
+            size_t position = style.style().find("}\n");
+            try {
+                style.edit(position, 2, "");
+            }
+            catch (const style::ParserException &) {
+            }
+            position = style.style().find("5px");
+            benchmarks::benchmark("Editing a value in an unclosed block before " + std::to_string(blocksCount) + " blocks with nested blocks",
+                                  [&style, position]() {
+                                      try {
+                                          style.edit(position, 1, (style.style()[position] == '5') ? "6" : "5");
+                                      }
+                                      catch (const style::ParserException &) {
+                                      }
+                                  },
+                                  100);
+        }
+    }
+
+    /**
+     * A converter used again keeps its buffers, so it must be faster than a new converter for each small style
+     */
+    void benchmarkSameConverter(const style::config::Config *config) {
+        const std::string style = "button {padding: 5px; &:hover {text-color: #fff;}}";
+        style::NodesToStyleComponents converter(config);
+        for (bool sameConverter : {false, true}) {
+            std::string name = std::string("Converting 10000 small styles with ") + (sameConverter ? "the same converter" : "a converter each");
+            benchmarks::benchmark(name, [&style, &converter, config, sameConverter]() {
+                int ruleNumber;
+                for (int i = 0; i < 10000; i++) {
+                    std::list<style::StyleDefinition *> *styleDefinitions;
+                    if (sameConverter) styleDefinitions = converter.convert(style, 0, &ruleNumber);
+                    else styleDefinitions = style::NodesToStyleComponents(config).convert(style, 0, &ruleNumber);
+                    for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                        delete styleDefinition;
+                    }
+                    delete styleDefinitions;
+                }
+            });
+        }
+    }
+
+    /**
+     * A compiled config is validated once and looks up the rules without building strings,
+     * so deserializing many small styles with it must be faster than with the config
+     */
+    void benchmarkCompiledConfig(const style::config::Config *config) {
+        const std::string style = "button {padding: 5px; text-color: #fff; &:hover {text-color: #000;}}";
+        const style::config::CompiledConfig compiledConfig(config);
+        for (bool compiled : {false, true}) {
+            std::string name = std::string("Deserializing 10000 small styles with ") + (compiled ? "a compiled config" : "the config");
+            benchmarks::benchmark(name, [&style, &compiledConfig, config, compiled]() {
+                int ruleNumber;
+                for (int i = 0; i < 10000; i++) {
+                    std::list<style::StyleDefinition *> *styleDefinitions;
+                    if (compiled) styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, &compiledConfig);
+                    else styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+                    for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                        delete styleDefinition;
+                    }
+                    delete styleDefinitions;
+                }
+            });
+        }
+    }
+
+    std::string nestedSelectors(int level, const std::string &indentation) {
+        std::string style = indentation + "&.a" + std::to_string(level) + ", .b" + std::to_string(level) + " span, #c" + std::to_string(level) +
+                            ", label:hover, .d" + std::to_string(level) + " > .e {\n" + indentation + "    padding: " + std::to_string(level) +
+                            "px;\n";
+        if (level < 4) style += nestedSelectors(level + 1, indentation + "    ");
+        return style + indentation + "}\n";
+    }
+
+    /**
+     * The selectors of the nested blocks are only joined to the ones of their parents when creating the definitions,
+     * without copying the nodes of each joined selector at each level
+     */
+    void benchmarkNestedSelectors(const style::config::Config *config) {
+        std::string style;
+        for (int i = 0; i < 100; i++) {
+            style += ".top" + std::to_string(i) + " {\n    padding: 0px;\n" + nestedSelectors(1, "    ") + "}\n";
+        }
+        for (bool compiled : {false, true}) {
+            std::string name = std::string(compiled ? "Compiling" : "Deserializing") + " 100 blocks with 4 levels of 5 nested selectors";
+            benchmarks::benchmark(name, [&style, config, compiled]() {
+                int ruleNumber;
+                std::list<style::StyleDefinition *> *styleDefinitions =
+                    compiled ? style::StyleDeserializer::compile(style, 0, &ruleNumber, config)
+                             : style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+                for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                    delete styleDefinition;
+                }
+                delete styleDefinitions;
+            });
+        }
+    }
+
+    /**
+     * The rules of a block are shared by the definitions of its selectors, so they aren't copied for each selector
+     */
+    void benchmarkManySelectors() {
+        style::config::Config *config = testConfig();
+        std::string style;
+        // the rule names can't contain digits
+        auto ruleName = [](int rule) { return "values-" + std::string(rule / 26 + 1, 'a' + rule % 26); };
+        for (int rule = 0; rule < 30; rule++) {
+            config->rules[ruleName(rule)] = {new style::config::ConfigRuleNode(style::Token::Tuple)};
+        }
+        for (int i = 0; i < 100; i++) {
+            style += ".a" + std::to_string(i);
+            for (int selector = 1; selector < 20; selector++) {
+                style += ", .b" + std::to_string(selector) + " label";
+            }
+            style += " {\n";
+            for (int rule = 0; rule < 30; rule++) {
+                style += "    " + ruleName(rule) + ": (1px, 2px, #ff0000);\n";
+            }
+            style += "}\n";
+        }
+        benchmarks::benchmark("Deserializing 100 blocks with 20 selectors and 30 rules", [&style, config]() {
+            int ruleNumber;
+            std::list<style::StyleDefinition *> *styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+            for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                delete styleDefinition;
+            }
+            delete styleDefinitions;
+        });
+        delete config;
+    }
+
+    /**
+     * Each value is matched once with the decision tree merging the alternatives of its rule,
+     * so many alternatives starting the same way must not multiply the time to validate it
+     */
+    void benchmarkRuleValidation() {
+        style::config::Config *config = testConfig();
+        std::string style = "label {\n";
+        std::vector<const style::config::ConfigRuleNode *> &alternatives = config->rules["margin"];
+        // tuples starting with any size or a color, followed by 1 to 8 pixel sizes
+        for (const style::Token lastToken : {style::Token::Unit, style::Token::Hex}) {
+            for (int size = 1; size <= 8; size++) {
+                style::config::ConfigRuleNode *elements = nullptr;
+                for (int i = 0; i < size; i++) {
+                    elements = new style::config::ConfigRuleNode(style::Token::Unit, new style::config::ConfigRuleNode(style::Token::Int), elements);
+                }
+                alternatives.push_back(new style::config::ConfigRuleNode(
+                    style::Token::Tuple, new style::config::ConfigRuleNode(lastToken, nullptr, elements)));
+            }
+        }
+        for (int i = 0; i < 10000; i++) {
+            style += "    margin: (#fff, 1px, 2px, 3px, 4px, 5px, 6px, " + std::to_string(i % 100) + "px);\n";
+        }
+        style += "}\n";
+        benchmarks::benchmark("Deserializing 10000 rules with 16 alternatives", [&style, config]() {
+            int ruleNumber;
+            std::list<style::StyleDefinition *> *styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+            for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                delete styleDefinition;
+            }
+            delete styleDefinitions;
+        });
+        delete config;
+    }
+
+    /**
+     * Querying the rules of a definition by the ids of their names is a binary search on integers, without hashing the names
+     */
+    void benchmarkIndexedRules() {
+        style::config::Config *config = testConfig();
+        std::string style = "label {\n";
+        std::vector<std::string> ruleNames;
+        for (int rule = 0; rule < 30; rule++) {
+            ruleNames.push_back("text-" + std::string(rule / 26 + 1, 'a' + rule % 26));
+            config->rules[ruleNames.back()] = {new style::config::ConfigRuleNode(style::Token::Hex)};
+            style += "    " + ruleNames.back() + ": #ff0000;\n";
+        }
+        style += "}\n";
+        const style::config::CompiledConfig compiledConfig(config);
+        std::vector<uint32_t> ruleIds;
+        for (const std::string &ruleName : ruleNames) {
+            ruleIds.push_back(compiledConfig.ruleId(ruleName));
+        }
+        int ruleNumber;
+        std::list<style::StyleDefinition *> *styleDefinitions = style::StyleDeserializer::compile(style, 0, &ruleNumber, &compiledConfig);
+        std::list<style::IndexedStyleDefinition *> *indexedDefinitions =
+            style::StyleDeserializer::deserializeIndexed(style, 0, &ruleNumber, &compiledConfig);
+        const style::StyleValuesMap &rules = *styleDefinitions->front()->second;
+        const style::IndexedRules &indexedRules = *indexedDefinitions->front()->second;
+        size_t found = 0;
+        benchmarks::benchmark("Looking up 1000000 rules by name", [&rules, &ruleNames, &found]() {
+            for (int i = 0; i < 1000000; i++) {
+                found += rules.count(ruleNames[i % ruleNames.size()]);
+            }
+        });
+        benchmarks::benchmark("Looking up 1000000 rules by id", [&indexedRules, &ruleIds, &found]() {
+            for (int i = 0; i < 1000000; i++) {
+                found += indexedRules.find(ruleIds[i % ruleIds.size()]) != nullptr;
+            }
+        });
+        if (found != 10000000) std::cerr << "Some rules weren't found\n";
+
+        for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+            delete styleDefinition;
+        }
+        for (style::IndexedStyleDefinition *indexedDefinition : *indexedDefinitions) {
+            delete indexedDefinition;
+        }
+        delete styleDefinitions;
+        delete indexedDefinitions;
+        delete config;
+    }
+
+    void benchmarkAppendNext() {
+        for (int nodesCount : {10000, 20000}) {
+            benchmarks::benchmark("Appending " + std::to_string(nodesCount) + " nexts to a child", [nodesCount]() {
+                style::DeserializationNode root = style::DeserializationNode(style::Token::NullRoot);
+                style::DeserializationNode *child = root.addChild(new style::DeserializationNode(style::Token::Int, "0"));
+                for (int i = 1; i < nodesCount; i++) {
+                    child->appendNext(new style::DeserializationNode(style::Token::Int, "0"));
+                }
+            });
+        }
+    }
+
+    void parserBenchmarks() {
+        style::config::Config *config = testConfig();
+        benchmarkBlockDeclarations(config);
+        benchmarkCompilation(config);
+        benchmarkIncrementalEdit(config);
+        benchmarkIncrementalEditAtStart(config);
+        benchmarkIncrementalEditInUnclosedBlock(config);
+        benchmarkSameConverter(config);
+        benchmarkCompiledConfig(config);
+        benchmarkNestedSelectors(config);
+        benchmarkManySelectors();
+        benchmarkRuleValidation();
+        benchmarkIndexedRules();
+        benchmarkAppendNext();
+        delete config;
+    }
+
+} // namespace parserBenchmarks
@@ -0,0 +1,17 @@
+#ifndef PARSER_BENCHMARKS_HPP
+#define PARSER_BENCHMARKS_HPP
+
+#include "../../src/deserialization_node.hpp"
+#include "../../src/incremental_style.hpp"
+#include "../../src/lexer.hpp"
+#include "../../src/nodes_to_style_components.hpp"
+#include "../../src/parser.hpp"
+#include "../../src/style_deserializer.hpp"
+#include "../../tests/test_config.hpp"
+#include "../benchmarks.hpp"
+
+namespace parserBenchmarks {
+    void parserBenchmarks();
+} // namespace parserBenchmarks
+
+#endif // PARSER_BENCHMARKS_HPP
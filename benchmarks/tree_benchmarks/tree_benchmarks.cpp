@@ -0,0 +1,88 @@
+#include "tree_benchmarks.hpp"
+
+namespace treeBenchmarks {
+
+    // root whose nodes are its nodesCount childs if nested is false, else a chain of nodesCount nodes each being the child of the previous one
+    style::DeserializationNode *nodesTree(int nodesCount, bool nested) {
+        style::DeserializationNode *root = new style::DeserializationNode(style::Token::Tuple);
+        style::DeserializationNode *parent = root;
+        for (int i = 0; i < nodesCount; i++) {
+            style::DeserializationNode *node = parent->addChild(new style::DeserializationNode(style::Token::Int, "1"));
+            if (nested) parent = node;
+        }
+        return root;
+    }
+
+    style::StyleValue *valuesTree(int valuesCount, bool nested) {
+        style::StyleValue *root = new style::StyleValue("", style::StyleValueType::Tuple);
+        style::StyleValue *parent = root;
+        style::StyleValue *last = nullptr;
+        for (int i = 0; i < valuesCount; i++) {
+            style::StyleValue *value = new style::StyleValue("1", style::StyleValueType::Int);
+            if (nested || last == nullptr) parent->addChild(value);
+            else {
+                last->next(value);
+                value->parent(parent);
+            }
+            if (nested) parent = value;
+            last = value;
+        }
+        return root;
+    }
+
+    /**
+     * Copying and deleting trees must take a time proportional to their number of nodes, and must not overflow the call stack,
+     * whether the nodes are siblings or nested
+     */
+    void benchmarkCopies() {
+        for (bool nested : {false, true}) {
+            for (int nodesCount : {100000, 200000}) {
+                std::string shape = std::to_string(nodesCount) + (nested ? " nested " : " sibling ");
+                style::DeserializationNode *nodes = nodesTree(nodesCount, nested);
+                benchmarks::benchmark("Copying and deleting " + shape + "nodes", [nodes]() { delete nodes->copyNodeWithChildsAndNexts(); });
+                delete nodes;
+                style::StyleValue *values = valuesTree(nodesCount, nested);
+                benchmarks::benchmark("Copying and deleting " + shape + "values", [values]() { delete values->copy(); });
+                delete values;
+            }
+        }
+    }
+
+    /**
+     * Deserializing a tuple must take a time proportional to its size, even when its values are nested tuples
+     */
+    void benchmarkTuples() {
+        style::config::Config *config = testConfig();
+        config->rules["values"] = {new style::config::ConfigRuleNode(style::Token::Tuple)};
+        for (bool nested : {false, true}) {
+            for (int valuesCount : {10000, 20000}) {
+                std::string style = "label {\n    values: ";
+                if (nested) style += std::string(valuesCount, '(') + "1" + std::string(valuesCount, ')');
+                else {
+                    style += "(1";
+                    for (int i = 1; i < valuesCount; i++) {
+                        style += ", 1";
+                    }
+                    style += ")";
+                }
+                style += ";\n}\n";
+                std::string name = "Deserializing a tuple of " + std::to_string(valuesCount) + (nested ? " nested tuples" : " values");
+                benchmarks::benchmark(name, [&style, config]() {
+                    int ruleNumber;
+                    std::list<style::StyleDefinition *> *styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+                    for (style::StyleDefinition *styleDefinition : *styleDefinitions) {
+                        delete styleDefinition;
+                    }
+                    delete styleDefinitions;
+                });
+            }
+        }
+        delete config;
+    }
+
+    void treeBenchmarks() {
+        benchmarkCopies();
+        benchmarkTuples();
+    }
+
+} // namespace treeBenchmarks
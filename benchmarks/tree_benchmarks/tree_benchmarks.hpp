@@ -0,0 +1,14 @@
+#ifndef TREE_BENCHMARKS_HPP
+#define TREE_BENCHMARKS_HPP
+
+#include "../../src/deserialization_node.hpp"
+#include "../../src/style_component.hpp"
+#include "../../src/style_deserializer.hpp"
+#include "../../tests/test_config.hpp"
+#include "../benchmarks.hpp"
+
+namespace treeBenchmarks {
+    void treeBenchmarks();
+} // namespace treeBenchmarks
+
+#endif // TREE_BENCHMARKS_HPP
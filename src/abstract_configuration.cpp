@@ -21,7 +21,7 @@ namespace style::config {
     }
 
     void configChecker(const Config *config) {
-        for (std::pair<std::string, std::vector<const ConfigRuleNode *>> rule : config->rules) {
+        for (const std::pair<const std::string, std::vector<const ConfigRuleNode *>> &rule : config->rules) {
             if (!Parser::isValidElementOrRuleName(rule.first)) throw InvalidStyleConfigException("'" + rule.first + "' is not a valid rule name");
             for (const ConfigRuleNode *configRule : rule.second) {
                 configNodeChecker(configRule);
@@ -40,7 +40,7 @@ namespace style::config {
     }
 
     Config::~Config() {
-        for (std::pair<std::string, std::vector<const ConfigRuleNode *>> rule : rules) {
+        for (const std::pair<const std::string, std::vector<const ConfigRuleNode *>> &rule : rules) {
             for (const ConfigRuleNode *value : rule.second) {
                 delete value;
             }
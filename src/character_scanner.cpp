@@ -0,0 +1,191 @@
+#include "character_scanner.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STYLE_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace style::scanner {
+
+    namespace scalar {
+
+        size_t findCharacter(std::string_view text, size_t start, char c) {
+            for (size_t i = start; i < text.size(); i++) {
+                if (text[i] == c) return i;
+            }
+            return text.size();
+        }
+
+        size_t skipBlanks(std::string_view text, size_t start) {
+            for (size_t i = start; i < text.size(); i++) {
+                if (text[i] != ' ' && text[i] != '\t') return i;
+            }
+            return text.size();
+        }
+
+        size_t findMultiLineCommentEnd(std::string_view text, size_t start) {
+            for (size_t i = start; i + 1 < text.size(); i++) {
+                if (text[i] == '*' && text[i + 1] == '/') return i;
+            }
+            return text.size();
+        }
+
+    } // namespace scalar
+
+#ifdef STYLE_SCANNER_X86
+
+    namespace sse2 {
+
+        __attribute__((target("sse2"))) size_t findCharacter(std::string_view text, size_t start, char c) {
+            const char *data = text.data();
+            const __m128i needle = _mm_set1_epi8(c);
+            size_t i = start;
+            for (; i + 16 <= text.size(); i += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return scalar::findCharacter(text, i, c);
+        }
+
+        __attribute__((target("sse2"))) size_t skipBlanks(std::string_view text, size_t start) {
+            const char *data = text.data();
+            const __m128i spaces = _mm_set1_epi8(' ');
+            const __m128i tabulations = _mm_set1_epi8('\t');
+            size_t i = start;
+            for (; i + 16 <= text.size(); i += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                __m128i blanks = _mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, tabulations));
+                unsigned int mask = ~static_cast<unsigned int>(_mm_movemask_epi8(blanks)) & 0xFFFFu;
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return scalar::skipBlanks(text, i);
+        }
+
+        __attribute__((target("sse2"))) size_t findMultiLineCommentEnd(std::string_view text, size_t start) {
+            const char *data = text.data();
+            const __m128i stars = _mm_set1_epi8('*');
+            const __m128i slashes = _mm_set1_epi8('/');
+            size_t i = start;
+            // the second load reads one character further, so 17 characters are needed
+            for (; i + 17 <= text.size(); i += 16) {
+                __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 1));
+                __m128i ends = _mm_and_si128(_mm_cmpeq_epi8(current, stars), _mm_cmpeq_epi8(next, slashes));
+                unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(ends));
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return scalar::findMultiLineCommentEnd(text, i);
+        }
+
+    } // namespace sse2
+
+    namespace avx2 {
+
+        __attribute__((target("avx2"))) size_t findCharacter(std::string_view text, size_t start, char c) {
+            const char *data = text.data();
+            const __m256i needle = _mm256_set1_epi8(c);
+            size_t i = start;
+            for (; i + 32 <= text.size(); i += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return sse2::findCharacter(text, i, c);
+        }
+
+        __attribute__((target("avx2"))) size_t skipBlanks(std::string_view text, size_t start) {
+            const char *data = text.data();
+            const __m256i spaces = _mm256_set1_epi8(' ');
+            const __m256i tabulations = _mm256_set1_epi8('\t');
+            size_t i = start;
+            for (; i + 32 <= text.size(); i += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                __m256i blanks = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, spaces), _mm256_cmpeq_epi8(chunk, tabulations));
+                unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(blanks));
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return sse2::skipBlanks(text, i);
+        }
+
+        __attribute__((target("avx2"))) size_t findMultiLineCommentEnd(std::string_view text, size_t start) {
+            const char *data = text.data();
+            const __m256i stars = _mm256_set1_epi8('*');
+            const __m256i slashes = _mm256_set1_epi8('/');
+            size_t i = start;
+            for (; i + 33 <= text.size(); i += 32) {
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+                __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 1));
+                __m256i ends = _mm256_and_si256(_mm256_cmpeq_epi8(current, stars), _mm256_cmpeq_epi8(next, slashes));
+                unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(ends));
+                if (mask) return i + __builtin_ctz(mask);
+            }
+            return sse2::findMultiLineCommentEnd(text, i);
+        }
+
+    } // namespace avx2
+
+#endif // STYLE_SCANNER_X86
+
+    namespace {
+
+        struct Scanners {
+            Implementation implementation;
+            size_t (*findCharacter)(std::string_view, size_t, char);
+            size_t (*skipBlanks)(std::string_view, size_t);
+            size_t (*findMultiLineCommentEnd)(std::string_view, size_t);
+        };
+
+        Scanners scannersOf(Implementation implementation) {
+            switch (implementation) {
+#ifdef STYLE_SCANNER_X86
+            case Implementation::Avx2:
+                return Scanners{implementation, avx2::findCharacter, avx2::skipBlanks, avx2::findMultiLineCommentEnd};
+            case Implementation::Sse2:
+                return Scanners{implementation, sse2::findCharacter, sse2::skipBlanks, sse2::findMultiLineCommentEnd};
+#endif
+            default:
+                return Scanners{Implementation::Scalar, scalar::findCharacter, scalar::skipBlanks, scalar::findMultiLineCommentEnd};
+            }
+        }
+
+        Scanners &scanners() {
+            static Scanners current = scannersOf(
+                isImplementationSupported(Implementation::Avx2)   ? Implementation::Avx2
+                : isImplementationSupported(Implementation::Sse2) ? Implementation::Sse2
+                                                                  : Implementation::Scalar);
+            return current;
+        }
+
+    } // namespace
+
+    bool isImplementationSupported(Implementation implementation) {
+        switch (implementation) {
+        case Implementation::Scalar:
+            return true;
+#ifdef STYLE_SCANNER_X86
+        case Implementation::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case Implementation::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    bool useImplementation(Implementation implementation) {
+        if (!isImplementationSupported(implementation)) return false;
+        scanners() = scannersOf(implementation);
+        return true;
+    }
+
+    Implementation currentImplementation() { return scanners().implementation; }
+
+    size_t findCharacter(std::string_view text, size_t start, char c) { return scanners().findCharacter(text, start, c); }
+
+    size_t skipBlanks(std::string_view text, size_t start) { return scanners().skipBlanks(text, start); }
+
+    size_t findMultiLineCommentEnd(std::string_view text, size_t start) { return scanners().findMultiLineCommentEnd(text, start); }
+
+} // namespace style::scanner
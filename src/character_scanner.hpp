@@ -0,0 +1,48 @@
+#ifndef CHARACTER_SCANNER_HPP
+#define CHARACTER_SCANNER_HPP
+
+#include <string_view>
+
+/**
+ * Functions used by the lexer to skip long sequences of characters (spaces, comments, strings).
+ * They process 16 (SSE2) or 32 (AVX2) characters at a time when the processor supports it,
+ * the implementation being chosen at runtime.
+ * All of them return text.size() if nothing is found, and start can be greater than text.size().
+ */
+namespace style::scanner {
+
+    enum class Implementation { Scalar, Sse2, Avx2 };
+
+    /**
+     * Index of the first character equal to c from start
+     */
+    size_t findCharacter(std::string_view text, size_t start, char c);
+    /**
+     * Index of the first character who is not a space or a tabulation from start
+     */
+    size_t skipBlanks(std::string_view text, size_t start);
+    /**
+     * Index of the '*' of the first "*\/" from start
+     */
+    size_t findMultiLineCommentEnd(std::string_view text, size_t start);
+
+    bool isImplementationSupported(Implementation implementation);
+    /**
+     * The best supported implementation is used by default.
+     * Return false (and keep the current implementation) if the given one is not supported.
+     */
+    bool useImplementation(Implementation implementation);
+    Implementation currentImplementation();
+
+    /**
+     * Reference implementations, one character at a time
+     */
+    namespace scalar {
+        size_t findCharacter(std::string_view text, size_t start, char c);
+        size_t skipBlanks(std::string_view text, size_t start);
+        size_t findMultiLineCommentEnd(std::string_view text, size_t start);
+    } // namespace scalar
+
+} // namespace style::scanner
+
+#endif // CHARACTER_SCANNER_HPP
@@ -0,0 +1,26 @@
+#include "compiled_config.hpp"
+
+#include <algorithm>
+
+namespace style::config {
+
+    CompiledConfig::CompiledConfig(const Config *config) : _config{config}, _units{config->units} {
+        configChecker(config);
+        for (const std::pair<const std::string, std::vector<const ConfigRuleNode *>> &rule : config->rules) {
+            _rulesNames.push_back(rule.first);
+        }
+        std::sort(_rulesNames.begin(), _rulesNames.end());
+        for (std::string_view ruleName : _rulesNames) {
+            const std::vector<const ConfigRuleNode *> &ruleNodes = config->rules.find(std::string(ruleName))->second;
+            _rulesIds.emplace(ruleName, _rulesNodes.size());
+            _rulesNodes.push_back(&ruleNodes);
+            _rulesMatchers.emplace_back(ruleNodes);
+        }
+    }
+
+    uint32_t CompiledConfig::ruleId(std::string_view ruleName) const {
+        std::unordered_map<std::string_view, uint32_t>::const_iterator rule = _rulesIds.find(ruleName);
+        return (rule == _rulesIds.cend()) ? NO_RULE : rule->second;
+    }
+
+} // namespace style::config
@@ -0,0 +1,54 @@
+#ifndef COMPILED_CONFIG_HPP
+#define COMPILED_CONFIG_HPP
+
+#include "abstract_configuration.hpp"
+#include "rule_matcher.hpp"
+#include "unit_matcher.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace style::config {
+
+    /**
+     * Config validated once, with the tables the deserializers look up for each rule, so a process loading many styles with the same
+     * config only pays for it once.
+     * The rules are numbered in the order of their names, and the names and the enum values reference the strings of the config,
+     * which must outlive the compiled config and must not be modified while it is used.
+     */
+    class CompiledConfig {
+        const Config *_config;
+        std::unordered_map<std::string_view, uint32_t> _rulesIds;
+        std::vector<std::string_view> _rulesNames;
+        std::vector<const std::vector<const ConfigRuleNode *> *> _rulesNodes;
+        std::vector<RuleMatcher> _rulesMatchers;
+        UnitMatcher _units;
+
+    public:
+        static constexpr uint32_t NO_RULE = UINT32_MAX;
+
+        /**
+         * Throws InvalidStyleConfigException if the config is invalid (see configChecker)
+         */
+        CompiledConfig(const Config *config);
+
+        const Config *config() const { return _config; }
+        /**
+         * NO_RULE if the config has no rule with this name
+         */
+        uint32_t ruleId(std::string_view ruleName) const;
+        std::string_view ruleName(uint32_t ruleId) const { return _rulesNames[ruleId]; }
+        const std::vector<const ConfigRuleNode *> &ruleNodes(uint32_t ruleId) const { return *_rulesNodes[ruleId]; }
+        uint32_t rulesCount() const { return _rulesNames.size(); }
+        /**
+         * Validator of the whole values of the rule, merging all its alternatives
+         */
+        const RuleMatcher &ruleMatcher(uint32_t ruleId) const { return _rulesMatchers[ruleId]; }
+        const UnitMatcher &units() const { return _units; }
+    };
+
+} // namespace style::config
+
+#endif // COMPILED_CONFIG_HPP
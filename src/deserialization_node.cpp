@@ -5,29 +5,93 @@
 
 namespace style {
 
-    std::string DeserializationNode::debugValue() const { return _value + " (" + tokenToString(_token) + ")"; };
+    namespace {
+        // each node is preceded by the arena it is allocated in, nullptr if it is allocated on the heap
+        constexpr size_t NODE_HEADER_SIZE = alignof(std::max_align_t);
+    } // namespace
 
-    DeserializationNode *DeserializationNode::copyNode() const {
-        DeserializationNode *n = new DeserializationNode;
-        n->token(token());
-        n->value(value());
+    void *DeserializationNode::operator new(size_t size) {
+        NodeArena *arena = NodeArena::current();
+        char *memory = static_cast<char *>(arena ? arena->allocate(NODE_HEADER_SIZE + size) : ::operator new(NODE_HEADER_SIZE + size));
+        *reinterpret_cast<NodeArena **>(memory) = arena;
+        return memory + NODE_HEADER_SIZE;
+    }
+
+    void DeserializationNode::operator delete(void *pointer) {
+        if (pointer == nullptr) return;
+        char *memory = static_cast<char *>(pointer) - NODE_HEADER_SIZE;
+        // the memory of the arenas is only freed by NodeArena::release
+        if (*reinterpret_cast<NodeArena **>(memory) == nullptr) ::operator delete(memory);
+    }
+
+    DeserializationNode::~DeserializationNode() {
+        std::vector<DeserializationNode *> nodes;
+        DeserializationNode *node = this;
+        while (true) {
+            if (node->child() != nullptr) nodes.push_back(node->child());
+            if (node->next() != nullptr) nodes.push_back(node->next());
+            // unlinked, so the destructor of commons::Node has nothing left to delete
+            node->commons::Node<DeserializationNode>::removeChilds();
+            node->next(nullptr);
+            if (node != this) delete node;
+            if (nodes.empty()) break;
+            node = nodes.back();
+            nodes.pop_back();
+        }
+    }
+
+    std::string DeserializationNode::debugValue() const { return std::string(value()) + " (" + tokenToString(_token) + ")"; };
+
+    DeserializationNode *DeserializationNode::copyNode() const { return copyNode(token()); }
+
+    DeserializationNode *DeserializationNode::copyNode(Token token) const {
+        DeserializationNode *n = new DeserializationNode(token);
+        if (_borrowed) n->borrowValue(_borrowedValue);
+        else n->value(_ownedValue);
+        n->number(_number);
         return n;
     }
 
+    DeserializationNode *DeserializationNode::copyNexts(const DeserializationNode *node, DeserializationNode *parent,
+                                                        std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> *copies) {
+        DeserializationNode *first = nullptr;
+        DeserializationNode *last = nullptr;
+        for (; node != nullptr; node = node->next()) {
+            DeserializationNode *copy = node->copyNode();
+            if (last == nullptr) first = copy;
+            else last->next(copy);
+            last = copy;
+            copies->emplace_back(node, copy);
+        }
+        // the whole list is added at once to its parent
+        if (parent != nullptr) parent->addChild(first);
+        return first;
+    }
+
+    void DeserializationNode::copyDescendants(std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> *copies) {
+        std::pair<const DeserializationNode *, DeserializationNode *> copy;
+        while (!copies->empty()) {
+            copy = copies->back();
+            copies->pop_back();
+            copyNexts(copy.first->child(), copy.second, copies);
+        }
+    }
+
     /**
      *Copy the node and his childs (not the nexts)
      */
     DeserializationNode *DeserializationNode::copyNodeWithChilds() const {
+        std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> copies;
         DeserializationNode *n = copyNode();
-        const DeserializationNode *childNode = child();
-        if (childNode != nullptr) n->setChild(childNode->copyNodeWithChildsAndNexts());
+        copies.emplace_back(this, n);
+        copyDescendants(&copies);
         return n;
     }
 
     DeserializationNode *DeserializationNode::copyNodeWithChildsAndNexts() const {
-        DeserializationNode *n = copyNodeWithChilds();
-        const DeserializationNode *nextNode = next();
-        if (nextNode != nullptr) n->next(nextNode->copyNodeWithChildsAndNexts());
+        std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> copies;
+        DeserializationNode *n = copyNexts(this, nullptr, &copies);
+        copyDescendants(&copies);
         return n;
     }
 
@@ -47,28 +111,74 @@ namespace style {
         }
     }
 
+    void DeserializationNode::firstChild(DeserializationNode *childNode) {
+        commons::Node<DeserializationNode>::removeChilds();
+        if (childNode != nullptr) commons::Node<DeserializationNode>::addChild(childNode);
+    }
+
+    bool DeserializationNode::isChild() const {
+        if (parent() == nullptr) return false;
+        return parent()->child() == this || (_previous != nullptr && _previous->next() == this && _previous->parent() == parent());
+    }
+
+    DeserializationNode *DeserializationNode::addChild(DeserializationNode *childNode) {
+        if (childNode == nullptr) return nullptr;
+        if (_lastChild == nullptr) firstChild(childNode);
+        else _lastChild->next(childNode);
+        childNode->_previous = _lastChild;
+        DeserializationNode *node = childNode;
+        while (true) {
+            node->parent(this);
+            _childsCount++;
+            if (node->next() == nullptr) break;
+            node->next()->_previous = node;
+            node = node->next();
+        }
+        _lastChild = node;
+        return childNode;
+    }
+
+    void DeserializationNode::removeChilds() {
+        commons::Node<DeserializationNode>::removeChilds();
+        _lastChild = nullptr;
+        _childsCount = 0;
+    }
+
+    void DeserializationNode::insertChildsAfter(DeserializationNode *previousChild, DeserializationNode *childNodes) {
+        if (childNodes == nullptr) return;
+        if (previousChild == _lastChild) {
+            addChild(childNodes);
+            return;
+        }
+        DeserializationNode *followingChild = previousChild->next();
+        DeserializationNode *node = childNodes;
+        previousChild->next(childNodes);
+        childNodes->_previous = previousChild;
+        while (true) {
+            node->parent(this);
+            _childsCount++;
+            if (node->next() == nullptr) break;
+            node->next()->_previous = node;
+            node = node->next();
+        }
+        node->next(followingChild);
+        followingChild->_previous = node;
+    }
+
     void DeserializationNode::setChild(DeserializationNode *childNode) {
         removeChilds();
         addChild(childNode);
-        if (childNode != nullptr) childNode->setParent(this);
     }
 
     void DeserializationNode::removeSpecificChild(DeserializationNode *childNode) {
-        if (childNode == nullptr) return;
-        if (childNode == child()) {
-            setChild(childNode->next());
-            childNode->next(nullptr);
-            return;
-        }
-        DeserializationNode *nextChild = child();
-        while (nextChild != nullptr) {
-            if (nextChild->next() == childNode) {
-                nextChild->next(childNode->next());
-                childNode->next(nullptr);
-                return;
-            }
-            nextChild = nextChild->next();
-        }
+        if (childNode == nullptr || childNode->parent() != this || !childNode->isChild()) return;
+        if (childNode == child()) firstChild(childNode->next());
+        else childNode->_previous->next(childNode->next());
+        if (childNode->next() != nullptr) childNode->next()->_previous = childNode->_previous;
+        else _lastChild = childNode->_previous;
+        childNode->next(nullptr);
+        childNode->_previous = nullptr;
+        _childsCount--;
     }
 
     void DeserializationNode::deleteSpecificChild(DeserializationNode *child) {
@@ -76,8 +186,17 @@ namespace style {
         delete child;
     }
 
+    DeserializationNode *DeserializationNode::detachChild(DeserializationNode *child) {
+        if (child == nullptr || child->parent() != this || !child->isChild()) return nullptr;
+        removeSpecificChild(child);
+        child->parent(nullptr);
+        return child;
+    }
+
     DeserializationNode *DeserializationNode::appendNext(DeserializationNode *next) {
         if (next == nullptr) return next;
+        // the last child of the parent is the last next
+        if (isChild()) return parent()->addChild(next);
         DeserializationNode *c = this;
         while (c->next() != nullptr) {
             c = c->next();
@@ -89,20 +208,28 @@ namespace style {
 
     void DeserializationNode::replaceData(DeserializationNode *tree) {
         if (tree == nullptr) return;
-        tree = tree->copyNodeWithChildsAndNexts();
         // copy node
-        value(tree->value());
+        if (tree->borrowsValue()) borrowValue(tree->value());
+        else value(tree->value());
+        number(tree->number());
         token(tree->token());
         // replace child
         delete child();
         setChild(tree->child());
-        if (child() != nullptr) {
-            child()->setParent(this);
-            tree->setChild(nullptr);
-        }
+        tree->removeChilds();
         // replace next
-        delete next();
-        next(tree->next());
+        DeserializationNode *parentNode = isChild() ? parent() : nullptr;
+        DeserializationNode *oldNext = next();
+        next(nullptr);
+        if (parentNode != nullptr) {
+            for (DeserializationNode *node = oldNext; node != nullptr; node = node->next()) {
+                parentNode->_childsCount--;
+            }
+            parentNode->_lastChild = this;
+            parentNode->addChild(tree->next());
+        }
+        else next(tree->next());
+        delete oldNext;
         tree->next(nullptr);
 
         delete tree;
@@ -113,26 +240,19 @@ namespace style {
      */
     void DeserializationNode::replaceChild(DeserializationNode *childNode, DeserializationNode *newChild) {
         if (childNode == nullptr || newChild == nullptr) return;
-        DeserializationNode *c = child();
         delete newChild->next();
-        if (c == childNode) {
-            newChild->next(c->next());
-            setChild(newChild);
-            c->next(nullptr);
-            delete c;
-            return;
-        }
-        while (c != nullptr) {
-            if (c->next() == childNode) {
-                newChild->next(c->next()->next());
-                c->next(newChild);
-                newChild->setParent(this);
-                childNode->next(nullptr);
-                delete childNode;
-                return;
-            }
-            c = c->next();
-        }
+        newChild->next(nullptr);
+        if (childNode->parent() != this || !childNode->isChild()) return;
+        if (childNode == child()) firstChild(newChild);
+        else childNode->_previous->next(newChild);
+        newChild->_previous = childNode->_previous;
+        newChild->next(childNode->next());
+        if (newChild->next() != nullptr) newChild->next()->_previous = newChild;
+        else _lastChild = newChild;
+        newChild->parent(this);
+        childNode->next(nullptr);
+        childNode->_previous = nullptr;
+        delete childNode;
     }
 
     DeserializationNode *root(DeserializationNode *node) {
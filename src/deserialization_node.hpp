@@ -2,28 +2,118 @@
 #define DESERIALIZATION_NODE_HPP
 
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "../cpp_commons/src/node.hpp"
+#include "node_arena.hpp"
+#include "number.hpp"
 #include "tokens.hpp"
 
 namespace style {
 
-    class DeserializationNode : public commons::Node<DeserializationNode> {
+    /**
+     * The base class is protected, so its methods changing the childs without the bookkeeping of this class
+     * (last child, number of childs and previous siblings) can't be called through a pointer to it.
+     */
+    class DeserializationNode : protected commons::Node<DeserializationNode> {
+        // the base class converts its pointers to this class
+        friend class commons::Node<DeserializationNode>;
+
         Token _token;
-        std::string _value;
+        std::string _ownedValue;
+        // when _borrowed is true, the value is a span of a source buffer owned by the caller instead of _ownedValue
+        std::string_view _borrowedValue;
+        bool _borrowed = false;
+        // decoded value of Int and Float nodes
+        Number _number;
+        // arena current when the node was created, where its copied values are stored
+        NodeArena *_arena;
+        // kept up to date by the methods changing the childs, so appending, removing or counting them doesn't walk the siblings
+        DeserializationNode *_lastChild = nullptr;
+        size_t _childsCount = 0;
+        // previous sibling, nullptr for the first child
+        DeserializationNode *_previous = nullptr;
+
+        // set the first child without walking its nexts nor updating the bookkeeping
+        void firstChild(DeserializationNode *childNode);
+        // true if the node is in the childs of its parent
+        bool isChild() const;
+        /**
+         * Copy the node and its nexts without their childs, each copy being added with its source to copies.
+         * The copies are added to the childs of parent if it isn't nullptr.
+         */
+        static DeserializationNode *copyNexts(const DeserializationNode *node, DeserializationNode *parent,
+                                              std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> *copies);
+        // copy the descendants of the sources of copies in their copies
+        static void copyDescendants(std::vector<std::pair<const DeserializationNode *, DeserializationNode *>> *copies);
 
     protected:
         std::string debugValue() const override;
 
     public:
-        DeserializationNode(Token token = Token::Empty, std::string value = "", DeserializationNode *parentNode = nullptr)
-            : _token{token}, _value{value} {
+        // accessors of the base class, its methods changing the childs being replaced by the ones below
+        using commons::Node<DeserializationNode>::child;
+        using commons::Node<DeserializationNode>::next;
+        using commons::Node<DeserializationNode>::parent;
+        using commons::Node<DeserializationNode>::debugDisplay;
+
+        DeserializationNode(Token token = Token::Empty, std::string_view value = "", DeserializationNode *parentNode = nullptr)
+            : _token{token}, _arena{NodeArena::current()} {
+            this->value(value);
             parent(parentNode);
         };
-        void value(const std::string &value) { _value = value; };
-        const std::string &value() const { return _value; };
+        /**
+         * Delete the childs and the nexts from an explicit stack instead of recursively, so a deep tree or a long list of nexts can't
+         * overflow the call stack.
+         * Every node is visited even if the tree is allocated in an arena, only releasing the arena (see NodeArena) frees such a tree
+         * in a constant time.
+         */
+        ~DeserializationNode() override;
+        /**
+         * Allocated in the current arena of the thread if there is one (see NodeArena)
+         */
+        static void *operator new(size_t size);
+        static void operator delete(void *pointer);
+        /**
+         * Copy the value in the node, or in its arena
+         */
+        void value(std::string_view value) {
+            if (_arena != nullptr) borrowValue(_arena->copy(value));
+            else {
+                _ownedValue = value;
+                _borrowed = false;
+            }
+        };
+        /**
+         * Make the node reference a part of a source buffer without copying it.
+         * The buffer must outlive the node and every node copied from it.
+         */
+        void borrowValue(std::string_view value) {
+            _ownedValue.clear();
+            _borrowedValue = value;
+            _borrowed = true;
+        };
+        std::string_view value() const { return _borrowed ? _borrowedValue : std::string_view(_ownedValue); };
+        bool borrowsValue() const { return _borrowed; };
+        void number(const Number &number) { _number = number; };
+        const Number &number() const { return _number; };
         void token(const Token &token) { _token = token; };
         const Token &token() const { return _token; };
+        /**
+         * Add the node and its nexts after the last child, in a time proportional to the number of added nodes.
+         * The sibling links of the childs must only be changed by the methods of their parent, which keep track of the last child.
+         */
+        DeserializationNode *addChild(DeserializationNode *childNode);
+        DeserializationNode *getLastChild() { return _lastChild; };
+        const DeserializationNode *getLastChild() const { return _lastChild; };
+        size_t nbChilds() const { return _childsCount; };
+        void removeChilds();
+        /**
+         * Insert the node and its nexts after a child
+         */
+        void insertChildsAfter(DeserializationNode *previousChild, DeserializationNode *childNodes);
         /**
          *Set parent for the node and the nexts nodes
          */
@@ -33,17 +123,29 @@ namespace style {
         void removeFirstChild() { setChild(nullptr); };
         void removeSpecificChild(DeserializationNode *child);
         void deleteSpecificChild(DeserializationNode *child);
+        /**
+         * Remove the child from the childs without deleting it, nor its own childs, so it can be added to an other node
+         */
+        DeserializationNode *detachChild(DeserializationNode *child);
         DeserializationNode *appendNext(DeserializationNode *next);
 
         /**
             *Replace the data of the node (value, token, childs and nexts)
-            *by the ones of the given tree.
-            Delete the last childs
+            *by the ones of the given tree, whose childs and nexts are moved instead of copied.
+            The tree must be detached from any parent (see detachChild).
+            Delete the last childs and the given node
         */
         void replaceData(DeserializationNode *tree);
         void replaceChild(DeserializationNode *child, DeserializationNode *newChild);
 
         DeserializationNode *copyNode() const;
+        /**
+         * Copy the node's value (borrowed or not) in a new node with the given token
+         */
+        DeserializationNode *copyNode(Token token) const;
+        /**
+         * The copies of the node and of its nexts are iterative, whatever the depth and the width of the tree
+         */
         DeserializationNode *copyNodeWithChilds() const;
         DeserializationNode *copyNodeWithChildsAndNexts() const;
         void displayNexts(std::ostream &flow = std::cout) const;
@@ -0,0 +1,58 @@
+#include "flat_tree.hpp"
+
+namespace style {
+
+    FlatTree FlatTree::fromNodes(const DeserializationNode *root) {
+        struct PendingNode {
+            const DeserializationNode *node;
+            uint32_t parent;
+            uint32_t previousSibling;
+        };
+        FlatTree tree;
+        std::vector<PendingNode> pendingNodes;
+        PendingNode pending;
+        uint32_t index;
+
+        if (root == nullptr) return tree;
+        pendingNodes.push_back({root, NO_NODE, NO_NODE});
+        while (!pendingNodes.empty()) {
+            pending = pendingNodes.back();
+            pendingNodes.pop_back();
+
+            index = static_cast<uint32_t>(tree._tokens.size());
+            tree._tokens.push_back(pending.node->token());
+            tree._valueStarts.push_back(static_cast<uint32_t>(tree._values.size()));
+            tree._valueLengths.push_back(static_cast<uint32_t>(pending.node->value().size()));
+            tree._values.append(pending.node->value());
+            tree._numbers.push_back(pending.node->number());
+            tree._firstChilds.push_back(NO_NODE);
+            tree._nextSiblings.push_back(NO_NODE);
+            tree._lastChilds.push_back(NO_NODE);
+            tree._parents.push_back(pending.parent);
+            if (pending.previousSibling != NO_NODE) tree._nextSiblings[pending.previousSibling] = index;
+            else if (pending.parent != NO_NODE) tree._firstChilds[pending.parent] = index;
+            // in preorder, the childs of a node come in their order
+            if (pending.parent != NO_NODE) tree._lastChilds[pending.parent] = index;
+
+            // the next node is pushed first so all the descendants of the node are visited before it
+            if (pending.node != root && pending.node->next() != nullptr) pendingNodes.push_back({pending.node->next(), pending.parent, index});
+            if (pending.node->child() != nullptr) pendingNodes.push_back({pending.node->child(), index, NO_NODE});
+        }
+        return tree;
+    }
+
+    DeserializationNode *FlatTree::toNodes() const {
+        std::vector<DeserializationNode *> nodes(size());
+
+        for (uint32_t i = 0; i < size(); i++) {
+            nodes[i] = new DeserializationNode(_tokens[i], value(i));
+            nodes[i]->number(_numbers[i]);
+        }
+        // in preorder, the childs of a node come in their order
+        for (uint32_t i = 1; i < size(); i++) {
+            nodes[_parents[i]]->addChild(nodes[i]);
+        }
+        return nodes.empty() ? nullptr : nodes[0];
+    }
+
+} // namespace style
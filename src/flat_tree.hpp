@@ -0,0 +1,59 @@
+#ifndef FLAT_TREE_HPP
+#define FLAT_TREE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "deserialization_node.hpp"
+#include "number.hpp"
+#include "tokens.hpp"
+
+namespace style {
+
+    /**
+     * Tree stored as contiguous arrays indexed by node, the nodes being in preorder (a node is followed by its descendants).
+     * The root is the node 0 and the values of all the nodes are stored in a single buffer.
+     * It is a copy of a tree of nodes (see fromNodes): the parser builds a tree of nodes which it rewrites in place while parsing,
+     * so the flat tree is only a layout converting its styles without moving nor deleting nodes, not a faster parsing.
+     */
+    class FlatTree {
+        std::vector<Token> _tokens;
+        std::vector<uint32_t> _valueStarts;
+        std::vector<uint32_t> _valueLengths;
+        std::vector<Number> _numbers;
+        std::vector<uint32_t> _firstChilds;
+        std::vector<uint32_t> _nextSiblings;
+        std::vector<uint32_t> _lastChilds;
+        std::vector<uint32_t> _parents;
+        std::string _values;
+
+    public:
+        // index of a missing child, sibling or parent
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+        /**
+         * Copy of a tree of nodes, including the values
+         */
+        static FlatTree fromNodes(const DeserializationNode *root);
+        /**
+         * Build back a tree of nodes, copying the values
+         */
+        DeserializationNode *toNodes() const;
+
+        size_t size() const { return _tokens.size(); }
+        bool empty() const { return _tokens.empty(); }
+        Token token(uint32_t node) const { return _tokens[node]; }
+        std::string_view value(uint32_t node) const { return std::string_view(_values).substr(_valueStarts[node], _valueLengths[node]); }
+        const Number &number(uint32_t node) const { return _numbers[node]; }
+        uint32_t firstChild(uint32_t node) const { return _firstChilds[node]; }
+        uint32_t nextSibling(uint32_t node) const { return _nextSiblings[node]; }
+        uint32_t parent(uint32_t node) const { return _parents[node]; }
+        // NO_NODE if the node has no child
+        uint32_t lastChild(uint32_t node) const { return _lastChilds[node]; }
+    };
+
+} // namespace style
+
+#endif // FLAT_TREE_HPP
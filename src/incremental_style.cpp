@@ -0,0 +1,322 @@
+#include "incremental_style.hpp"
+#include "character_scanner.hpp"
+#include "lexer.hpp"
+#include "parallel_parser.hpp"
+#include "parser.hpp"
+#include "style_compiler.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace style {
+
+    namespace {
+        // true if a string or a multi-line comment isn't closed at the end of the expression, like ParallelParser::splitPoints finds them
+        bool endsInStringOrComment(std::string_view expression) {
+            size_t i = 0;
+            while (i < expression.size()) {
+                if (expression[i] == '"' || expression[i] == '\'') i = scanner::findCharacter(expression, i + 2, expression[i]);
+                else if (expression[i] == '/' && i + 1 < expression.size() && expression[i + 1] == '/') {
+                    i = scanner::findCharacter(expression, i + 2, '\n');
+                    // a line comment is closed by the line break after the chunk
+                    if (i == expression.size()) return false;
+                }
+                else if (expression[i] == '/' && i + 1 < expression.size() && expression[i + 1] == '*') {
+                    i = scanner::findMultiLineCommentEnd(expression, i + 2);
+                    if (i < expression.size()) i++;
+                }
+                else {
+                    i++;
+                    continue;
+                }
+                if (i == expression.size()) return true;
+                i++;
+            }
+            return false;
+        }
+    } // namespace
+
+    IncrementalStyle::IncrementalStyle(const std::string &style, int fileNumber, const config::Config *config)
+        : _config{nullptr}, _ownedConfig{new config::CompiledConfig(config)}, _fileNumber{fileNumber}, _style{style} {
+        _config = _ownedConfig;
+        try {
+            deserializeAll();
+        }
+        catch (...) {
+            delete _ownedConfig;
+            throw;
+        }
+    }
+
+    IncrementalStyle::IncrementalStyle(const std::string &style, int fileNumber, const config::CompiledConfig *config)
+        : _config{config}, _fileNumber{fileNumber}, _style{style} {
+        deserializeAll();
+    }
+
+    IncrementalStyle::~IncrementalStyle() {
+        clear();
+        delete _ownedConfig;
+    }
+
+    size_t IncrementalStyle::chunkAt(size_t position) const {
+        // first chunk starting after position, searched from the second one
+        size_t first = 1;
+        size_t last = _chunks.size();
+        size_t middle;
+        while (first < last) {
+            middle = first + (last - first) / 2;
+            if (chunkStart(middle) <= position) first = middle + 1;
+            else last = middle;
+        }
+        return first - 1;
+    }
+
+    void IncrementalStyle::shiftRulesNumbers(std::list<StyleDefinition *>::iterator first, std::list<StyleDefinition *>::iterator last, int delta) {
+        std::list<StyleDefinition *>::iterator blockEnd;
+        std::shared_ptr<const StyleValuesMap> rules;
+        std::shared_ptr<StyleValuesMap> shiftedRules;
+        long owners;
+        if (!delta) return;
+        for (; first != last; first = blockEnd) {
+            rules = (*first)->second;
+            owners = 0;
+            for (blockEnd = first; blockEnd != last && (*blockEnd)->second == rules; blockEnd++) {
+                owners++;
+            }
+            // the rules are always created modifiable, and can only be shifted in place if they aren't held outside of the style
+            if (rules.use_count() - 1 == owners) shiftedRules = std::const_pointer_cast<StyleValuesMap>(rules);
+            else shiftedRules = std::make_shared<StyleValuesMap>(*rules);
+            for (std::pair<const std::string, StyleRule> &rule : *shiftedRules) {
+                rule.second.ruleNumber += delta;
+            }
+            for (std::list<StyleDefinition *>::iterator definition = first; definition != blockEnd; definition++) {
+                (*definition)->second = shiftedRules;
+            }
+        }
+    }
+
+    void IncrementalStyle::moveChunks(size_t firstChunk, long shift) {
+        if (_startsShift) {
+            for (size_t chunk = _firstMovedChunk; chunk < firstChunk; chunk++) {
+                _chunks[chunk].start += _startsShift;
+            }
+            // moved again with the next ones
+            for (size_t chunk = firstChunk; chunk < _firstMovedChunk; chunk++) {
+                _chunks[chunk].start -= _startsShift;
+            }
+        }
+        _firstMovedChunk = firstChunk;
+        _startsShift = (firstChunk < _chunks.size()) ? _startsShift + shift : 0;
+    }
+
+    void IncrementalStyle::shiftChunksRules(size_t firstChunk, int delta) const {
+        auto shiftChunkRules = [](Chunk &chunk, int delta) {
+            shiftRulesNumbers(chunk.firstDefinition, std::next(chunk.firstDefinition, chunk.definitionsCount), delta);
+            chunk.rulesOffset += delta;
+        };
+        if (_rulesShift) {
+            for (size_t chunk = _firstUnresolvedChunk; chunk < firstChunk; chunk++) {
+                shiftChunkRules(_chunks[chunk], _rulesShift);
+            }
+            // shifted again with the next ones
+            for (size_t chunk = firstChunk; chunk < _firstUnresolvedChunk; chunk++) {
+                shiftChunkRules(_chunks[chunk], -_rulesShift);
+            }
+        }
+        _firstUnresolvedChunk = firstChunk;
+        _rulesShift = (firstChunk < _chunks.size()) ? _rulesShift + delta : 0;
+    }
+
+    void IncrementalStyle::replaceChunks(size_t firstChunk, size_t lastChunk, const std::vector<Chunk> &newChunks,
+                                         std::list<StyleDefinition *> *newDefinitions) {
+        std::list<StyleDefinition *>::iterator position = _definitions.end();
+        long shift = 0;
+        int rulesDelta = 0;
+        // the definitions of the replaced chunks are deleted, the new ones take their place
+        for (size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+            shift -= static_cast<long>(_chunks[chunk].length);
+            rulesDelta -= _chunks[chunk].rulesCount;
+            for (size_t i = 0; i < _chunks[chunk].definitionsCount; i++) {
+                delete *_chunks[chunk].firstDefinition;
+                position = _definitions.erase(_chunks[chunk].firstDefinition);
+                _chunks[chunk].firstDefinition = position;
+            }
+            // left out of the shift of the next chunks below
+            _chunks[chunk].definitionsCount = 0;
+        }
+        if (position == _definitions.end()) {
+            for (size_t chunk = lastChunk; chunk < _chunks.size(); chunk++) {
+                if (_chunks[chunk].definitionsCount) {
+                    position = _chunks[chunk].firstDefinition;
+                    break;
+                }
+            }
+        }
+        for (const Chunk &chunk : newChunks) {
+            shift += static_cast<long>(chunk.length);
+            rulesDelta += chunk.rulesCount;
+        }
+        moveChunks(lastChunk, shift);
+        shiftChunksRules(lastChunk, rulesDelta);
+        // the iterators of the new definitions stay valid once spliced
+        _definitions.splice(position, *newDefinitions);
+        _chunks.erase(_chunks.begin() + firstChunk, _chunks.begin() + lastChunk);
+        _chunks.insert(_chunks.begin() + firstChunk, newChunks.begin(), newChunks.end());
+        // the chunks moved and shifted are now after the new ones
+        _firstMovedChunk = firstChunk + newChunks.size();
+        _firstUnresolvedChunk = _firstMovedChunk;
+        _rulesCount += rulesDelta;
+    }
+
+    void IncrementalStyle::deserializeChunks(size_t firstChunk, size_t lastChunk, size_t start, size_t end, bool split) {
+        std::string_view region = std::string_view(_style).substr(start, end - start);
+        std::vector<size_t> points = split ? ParallelParser::splitPoints(region, _config->config(), 0) : std::vector<size_t>{region.size()};
+        std::vector<Chunk> newChunks;
+        std::list<StyleDefinition *> newDefinitions;
+        std::list<StyleDefinition *> *chunkDefinitions;
+        size_t chunkStart = 0;
+        int ruleNumber = 0;
+        // the rules of the new chunks are numbered after the ones of the previous chunk
+        int rulesOffset = firstChunk ? chunkRulesOffset(firstChunk - 1) + _chunks[firstChunk - 1].rulesCount : 0;
+
+        try {
+            for (size_t point : points) {
+                chunkDefinitions =
+                    StyleCompiler(_config).compile(std::string(region.substr(chunkStart, point - chunkStart)), _fileNumber, &ruleNumber);
+                // only owned by the new definitions, the rules are shifted in place
+                shiftRulesNumbers(chunkDefinitions->begin(), chunkDefinitions->end(), rulesOffset);
+                // a chunk without definitions (only comments or white spaces) references the end of the definitions, which stays valid
+                newChunks.push_back({start + chunkStart, point - chunkStart,
+                                     chunkDefinitions->empty() ? _definitions.end() : chunkDefinitions->begin(), chunkDefinitions->size(),
+                                     ruleNumber, rulesOffset});
+                rulesOffset += ruleNumber;
+                newDefinitions.splice(newDefinitions.end(), *chunkDefinitions);
+                delete chunkDefinitions;
+                chunkStart = point;
+            }
+        }
+        catch (const std::exception &) {
+            for (StyleDefinition *styleDefinition : newDefinitions) {
+                delete styleDefinition;
+            }
+            throw;
+        }
+        replaceChunks(firstChunk, lastChunk, newChunks, &newDefinitions);
+    }
+
+    void IncrementalStyle::deserializeRegion(size_t firstChunk, size_t lastChunk, long shift) {
+        size_t start = chunkStart(firstChunk);
+        size_t end = chunkEnd(lastChunk - 1) + shift;
+        try {
+            deserializeChunks(firstChunk, lastChunk, start, end);
+            _valid = true;
+            return;
+        }
+        catch (const ParserException &) {
+        }
+        catch (const LexerException &) {
+        }
+
+        // a chunk can be invalid on its own but not in the style, like a '&' at the start of a top level block
+        if (firstChunk) firstChunk--;
+        start = chunkStart(firstChunk);
+        while (true) {
+            try {
+                deserializeChunks(firstChunk, lastChunk, start, end, false);
+                _valid = true;
+                return;
+            }
+            catch (const ParserException &) {
+                // the next chunks are parsed on their own and can't close the blocks of the region, so the error is in the region
+                invalidate(firstChunk, lastChunk, start, end);
+                throw;
+            }
+            catch (const LexerException &) {
+                // a string or a comment can be closed in the next chunks, added until the end of the style
+                if (lastChunk == _chunks.size() || !endsInStringOrComment(std::string_view(_style).substr(start, end - start))) {
+                    invalidate(firstChunk, lastChunk, start, end);
+                    throw;
+                }
+            }
+            for (size_t added = lastChunk - firstChunk; added && lastChunk < _chunks.size(); added--) {
+                end += _chunks[lastChunk].length;
+                lastChunk++;
+            }
+        }
+    }
+
+    void IncrementalStyle::invalidate(size_t firstChunk, size_t lastChunk, size_t start, size_t end) {
+        int rulesOffset = firstChunk ? chunkRulesOffset(firstChunk - 1) + _chunks[firstChunk - 1].rulesCount : 0;
+        std::list<StyleDefinition *> noDefinitions;
+        replaceChunks(firstChunk, lastChunk, {{start, end - start, _definitions.end(), 0, 0, rulesOffset}}, &noDefinitions);
+        _valid = false;
+        _invalidChunk = firstChunk;
+    }
+
+    void IncrementalStyle::deserializeAll() {
+        clear();
+        try {
+            deserializeChunks(0, 0, 0, _style.size());
+        }
+        catch (const ParserException &) {
+            // a chunk can be invalid on its own but not in the style, like a '&' at the start of a top level block,
+            // while the lexer errors don't depend on the chunks and are raised directly
+            deserializeChunks(0, 0, 0, _style.size(), false);
+        }
+        _valid = true;
+    }
+
+    void IncrementalStyle::clear() {
+        for (StyleDefinition *styleDefinition : _definitions) {
+            delete styleDefinition;
+        }
+        _definitions.clear();
+        _chunks.clear();
+        _firstMovedChunk = 0;
+        _startsShift = 0;
+        _firstUnresolvedChunk = 0;
+        _rulesShift = 0;
+        _rulesCount = 0;
+        _valid = false;
+    }
+
+    void IncrementalStyle::edit(size_t start, size_t length, const std::string &replacement) {
+        if (start > _style.size() || length > _style.size() - start) throw std::out_of_range("The edit is outside of the style");
+        size_t oldSize = _style.size();
+        _style.replace(start, length, replacement);
+        if (_chunks.empty() || oldSize == 0) {
+            deserializeAll();
+            return;
+        }
+
+        // the chunk before the edit is included since its end can be changed, like "a {}\n" becoming "a {} .b"
+        size_t firstChunk = chunkAt(start ? start - 1 : 0);
+        size_t lastChunk = chunkAt(std::min(start + length, oldSize - 1)) + 1;
+        // the invalid chunk is parsed again with the edit, which can close its blocks, strings or comments
+        if (!_valid) {
+            firstChunk = std::min(firstChunk, _invalidChunk);
+            lastChunk = std::max(lastChunk, _invalidChunk + 1);
+        }
+        try {
+            deserializeRegion(firstChunk, lastChunk, static_cast<long>(replacement.size()) - static_cast<long>(length));
+        }
+        catch (const ParserException &) {
+            throw;
+        }
+        catch (const LexerException &) {
+            throw;
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    const std::list<StyleDefinition *> &IncrementalStyle::definitions() const {
+        static const std::list<StyleDefinition *> noDefinitions;
+        if (!_valid) return noDefinitions;
+        resolveRulesNumbers();
+        return _definitions;
+    }
+
+} // namespace style
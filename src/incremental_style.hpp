@@ -0,0 +1,120 @@
+#ifndef INCREMENTAL_STYLE_HPP
+#define INCREMENTAL_STYLE_HPP
+
+#include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
+#include "style_component.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace style {
+
+    /**
+     * Deserialized style kept with its source, so an edit only deserializes again the top level blocks around it.
+     * The style is split like ParallelParser does (after the top level blocks followed by a line break), each chunk being compiled on its
+     * own, and an edit compiles again the chunks it touches, reusing the definitions of the other ones.
+     * The definitions are always the ones StyleDeserializer::deserialize would give for the edited style, with the same rules numbers.
+     */
+    class IncrementalStyle {
+        struct Chunk {
+            // outdated for the chunks from _firstMovedChunk, see chunkStart
+            size_t start;
+            size_t length;
+            // first of the definitionsCount definitions of the chunk in _definitions, its end if the chunk has no definitions
+            std::list<StyleDefinition *>::iterator firstDefinition;
+            size_t definitionsCount;
+            int rulesCount;
+            // number of the rules of the previous chunks, added to the rules numbers of the chunk
+            int rulesOffset;
+        };
+
+        const config::CompiledConfig *_config;
+        // compiled from the config the style was given, nullptr when it was given a compiled config
+        config::CompiledConfig *_ownedConfig = nullptr;
+        int _fileNumber;
+        std::string _style;
+        // the offsets of the chunks are resolved when the definitions are read
+        mutable std::vector<Chunk> _chunks;
+        // the starts of the chunks from _firstMovedChunk are shifted by _startsShift, applied to them once an edit reaches them
+        size_t _firstMovedChunk = 0;
+        long _startsShift = 0;
+        // the rules of the chunks from _firstUnresolvedChunk are shifted by _rulesShift, applied to them once the definitions are read
+        mutable size_t _firstUnresolvedChunk = 0;
+        mutable int _rulesShift = 0;
+        std::list<StyleDefinition *> _definitions;
+        int _rulesCount = 0;
+        // false after an edit leaving the style invalid, until an edit parses again the invalid chunk
+        bool _valid = false;
+        // chunk without definitions replacing the chunks who couldn't be parsed, included in the next edits
+        size_t _invalidChunk = 0;
+
+        size_t chunkStart(size_t chunk) const { return _chunks[chunk].start + ((chunk >= _firstMovedChunk) ? _startsShift : 0); }
+        size_t chunkEnd(size_t chunk) const { return chunkStart(chunk) + _chunks[chunk].length; }
+        int chunkRulesOffset(size_t chunk) const { return _chunks[chunk].rulesOffset + ((chunk >= _firstUnresolvedChunk) ? _rulesShift : 0); }
+        size_t chunkAt(size_t position) const;
+        /**
+         * Add delta to the rules numbers of the definitions between first and last, the rules shared by consecutive definitions
+         * (the selectors of a block) being shifted once.
+         * The rules are shifted in place if these definitions are their only owners, and replaced by a shifted copy if they are also held
+         * outside of the style, so the rules already read are left unchanged.
+         */
+        static void shiftRulesNumbers(std::list<StyleDefinition *>::iterator first, std::list<StyleDefinition *>::iterator last, int delta);
+        // shift the starts of the chunks from firstChunk, only updating the ones between the chunks already moved and firstChunk
+        void moveChunks(size_t firstChunk, long shift);
+        // shift the rules of the chunks from firstChunk, only updating the ones between the chunks already shifted and firstChunk
+        void shiftChunksRules(size_t firstChunk, int delta) const;
+        void resolveRulesNumbers() const { shiftChunksRules(_chunks.size(), 0); }
+        // replace the chunks [firstChunk, lastChunk[ by newChunks and their definitions, moving the next chunks and shifting their rules
+        void replaceChunks(size_t firstChunk, size_t lastChunk, const std::vector<Chunk> &newChunks, std::list<StyleDefinition *> *newDefinitions);
+        /**
+         * Replace the chunks [firstChunk, lastChunk[ by the ones of the style between start and end, or by a single chunk if split is false.
+         * Nothing is changed if the new chunks can't be deserialized.
+         */
+        void deserializeChunks(size_t firstChunk, size_t lastChunk, size_t start, size_t end, bool split = true);
+        /**
+         * Deserialize again the chunks [firstChunk, lastChunk[ whose text was edited, its length being changed by shift.
+         * If they can't be parsed, they are parsed in one piece with the previous chunk, and with the next ones while the error could
+         * come from a string or a comment closed after them, before being replaced by an invalid chunk.
+         */
+        void deserializeRegion(size_t firstChunk, size_t lastChunk, long shift);
+        // replace the chunks [firstChunk, lastChunk[ by an invalid chunk between start and end
+        void invalidate(size_t firstChunk, size_t lastChunk, size_t start, size_t end);
+        void deserializeAll();
+        void clear();
+
+    public:
+        /**
+         * Throws the exceptions of StyleDeserializer::deserialize if the style is invalid
+         */
+        IncrementalStyle(const std::string &style, int fileNumber, const config::Config *config);
+        /**
+         * The compiled config must outlive the style, the edits don't validate it again
+         */
+        IncrementalStyle(const std::string &style, int fileNumber, const config::CompiledConfig *config);
+        ~IncrementalStyle();
+        IncrementalStyle(const IncrementalStyle &) = delete;
+        IncrementalStyle &operator=(const IncrementalStyle &) = delete;
+
+        /**
+         * Replace the length characters at start by replacement.
+         * Only the chunks touching the edit are lexed and parsed again, the positions and the rules numbers of the next ones being shifted
+         * lazily, so consecutive edits only update the chunks between them and the rules numbers are shifted once the definitions are read.
+         * If the edited chunks can't be parsed, the region of the error is replaced by an invalid chunk parsed again by the next edits,
+         * and its exception is thrown. It's the one of StyleDeserializer::deserialize unless an unclosed block would contain the next
+         * chunks, whose errors in the block aren't searched. The definitions are then empty until an edit makes the style valid again.
+         */
+        void edit(size_t start, size_t length, const std::string &replacement);
+        const std::string &style() const { return _style; }
+        /**
+         * Owned by the style, the definitions of the chunks not touched by an edit are the same objects before and after it
+         */
+        const std::list<StyleDefinition *> &definitions() const;
+        // the ruleNumber given by StyleDeserializer::deserialize, 0 while the style is invalid
+        int rulesCount() const { return _valid ? _rulesCount : 0; }
+    };
+
+} // namespace style
+
+#endif // INCREMENTAL_STYLE_HPP
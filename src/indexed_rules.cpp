@@ -0,0 +1,52 @@
+#include "indexed_rules.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace style {
+
+    IndexedRules::IndexedRules(StyleValuesMap &&rules, const config::CompiledConfig *config) {
+        uint32_t ruleId;
+        _rules.reserve(rules.size());
+        for (std::pair<const std::string, StyleRule> &rule : rules) {
+            ruleId = config->ruleId(rule.first);
+            if (ruleId != config::CompiledConfig::NO_RULE) _rules.emplace_back(ruleId, std::move(rule.second));
+        }
+        std::sort(_rules.begin(), _rules.end(),
+                  [](const std::pair<uint32_t, StyleRule> &a, const std::pair<uint32_t, StyleRule> &b) { return a.first < b.first; });
+    }
+
+    const StyleRule *IndexedRules::find(uint32_t ruleId) const {
+        const_iterator rule = std::lower_bound(_rules.cbegin(), _rules.cend(), ruleId,
+                                               [](const std::pair<uint32_t, StyleRule> &rule, uint32_t id) { return rule.first < id; });
+        return (rule != _rules.cend() && rule->first == ruleId) ? &rule->second : nullptr;
+    }
+
+    std::list<IndexedStyleDefinition *> *indexStyleDefinitions(std::list<StyleDefinition *> *styleDefinitions,
+                                                               const config::CompiledConfig *config) {
+        std::list<IndexedStyleDefinition *> *indexedDefinitions = new std::list<IndexedStyleDefinition *>();
+        // the rules of a block are indexed once for all its definitions
+        std::unordered_map<const StyleValuesMap *, std::shared_ptr<const IndexedRules>> indexedRules;
+        // number of definitions of the list sharing each rules
+        std::unordered_map<const StyleValuesMap *, long> owners;
+        std::shared_ptr<const IndexedRules> *rules;
+        for (const StyleDefinition *styleDefinition : *styleDefinitions) {
+            owners[styleDefinition->second.get()]++;
+        }
+        for (StyleDefinition *styleDefinition : *styleDefinitions) {
+            rules = &indexedRules[styleDefinition->second.get()];
+            if (*rules == nullptr) {
+                // the rules only owned by the definitions of the list, which are deleted, are moved, the ones held elsewhere are copied
+                if (styleDefinition->second.use_count() == owners[styleDefinition->second.get()]) {
+                    *rules = std::make_shared<const IndexedRules>(std::move(const_cast<StyleValuesMap &>(*styleDefinition->second)), config);
+                }
+                else *rules = std::make_shared<const IndexedRules>(StyleValuesMap(*styleDefinition->second), config);
+            }
+            indexedDefinitions->push_back(new IndexedStyleDefinition(std::move(styleDefinition->first), *rules, styleDefinition->specificity));
+            delete styleDefinition;
+        }
+        delete styleDefinitions;
+        return indexedDefinitions;
+    }
+
+} // namespace style
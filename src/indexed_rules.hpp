@@ -0,0 +1,62 @@
+#ifndef INDEXED_RULES_HPP
+#define INDEXED_RULES_HPP
+
+#include "compiled_config.hpp"
+#include "style_component.hpp"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace style {
+
+    /**
+     * Rules of a block identified by the ids of their names in a compiled config (see config::CompiledConfig::ruleId),
+     * sorted in a small vector so a query is a binary search on integers instead of hashing the name of the rule.
+     * The names aren't stored, config::CompiledConfig::ruleName gives them back.
+     */
+    class IndexedRules {
+        std::vector<std::pair<uint32_t, StyleRule>> _rules;
+
+    public:
+        using const_iterator = std::vector<std::pair<uint32_t, StyleRule>>::const_iterator;
+
+        /**
+         * The rules whose name isn't in the config are dropped, which never happens for the rules deserialized with it
+         */
+        IndexedRules(StyleValuesMap &&rules, const config::CompiledConfig *config);
+        /**
+         * nullptr if the block has no rule with this id
+         */
+        const StyleRule *find(uint32_t ruleId) const;
+        size_t size() const { return _rules.size(); }
+        bool empty() const { return _rules.empty(); }
+        const_iterator begin() const { return _rules.cbegin(); }
+        const_iterator end() const { return _rules.cend(); }
+    };
+
+    /**
+     * Same as StyleDefinition, with the rules of the block indexed by their ids, still shared by the definitions of the block
+     */
+    struct IndexedStyleDefinition {
+        StyleComponentDataList first;
+        std::shared_ptr<const IndexedRules> second;
+        int specificity;
+
+        IndexedStyleDefinition(StyleComponentDataList &&components, std::shared_ptr<const IndexedRules> rules, int specificity)
+            : first{std::move(components)}, second{std::move(rules)}, specificity{specificity} {}
+    };
+
+    /**
+     * Index the rules of the definitions, which are deleted with their list, their rules being moved and not copied unless they are
+     * also held outside of the list.
+     * The config must be the one the definitions were deserialized with.
+     */
+    std::list<IndexedStyleDefinition *> *indexStyleDefinitions(std::list<StyleDefinition *> *styleDefinitions,
+                                                               const config::CompiledConfig *config);
+
+} // namespace style
+
+#endif // INDEXED_RULES_HPP
@@ -1,14 +1,73 @@
 #include "lexer.hpp"
 
+#include <algorithm>
+
+#include "character_scanner.hpp"
+
 namespace style {
 
-    size_t Lexer::lexeSpace() {
-        size_t i = 0;
-        while (_index + i < _expression.length() && (_expression[_index + i] == ' ' || _expression[_index + i] == '\t')) {
-            i++;
+    const std::array<CharacterClass, 256> CHARACTER_CLASSES = []() {
+        std::array<CharacterClass, 256> classes;
+        classes.fill(CharacterClass::Other);
+        for (int c = 'a'; c <= 'z'; c++) {
+            classes[c] = CharacterClass::Letter;
+        }
+        for (int c = 'A'; c <= 'Z'; c++) {
+            classes[c] = CharacterClass::Letter;
+        }
+        for (int c = '0'; c <= '9'; c++) {
+            classes[c] = CharacterClass::Digit;
         }
+        for (const std::pair<const char, Token> &reservedCharacter : RESERVED_CHARACTERS) {
+            classes[static_cast<unsigned char>(reservedCharacter.first)] = CharacterClass::Reserved;
+        }
+        classes[static_cast<unsigned char>(TRUE[0])] = CharacterClass::BoolStart;
+        classes[static_cast<unsigned char>(FALSE[0])] = CharacterClass::BoolStart;
+        classes[' '] = CharacterClass::Space;
+        classes['\t'] = CharacterClass::Space;
+        classes['\n'] = CharacterClass::LineBreak;
+        classes['/'] = CharacterClass::Slash;
+        classes['"'] = CharacterClass::DoubleQuote;
+        classes['\''] = CharacterClass::SingleQuote;
+        classes['-'] = CharacterClass::Minus;
+        classes['.'] = CharacterClass::Dot;
+        classes['_'] = CharacterClass::Underscore;
+        return classes;
+    }();
+
+    const std::array<Token, 256> RESERVED_CHARACTERS_TOKENS = []() {
+        std::array<Token, 256> tokens;
+        tokens.fill(Token::Empty);
+        for (const std::pair<const char, Token> &reservedCharacter : RESERVED_CHARACTERS) {
+            tokens[static_cast<unsigned char>(reservedCharacter.first)] = reservedCharacter.second;
+        }
+        return tokens;
+    }();
+
+    bool Lexer::isRawNameCharacter(char c) {
+        switch (characterClass(c)) {
+        case CharacterClass::Digit:
+        case CharacterClass::BoolStart:
+        case CharacterClass::Letter:
+        case CharacterClass::Minus:
+        case CharacterClass::Underscore:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool Lexer::canEndNumber(size_t index) {
+        if (_index + index >= _expression.length()) return true;
+        char c = _expression[_index + index];
+        return RESERVED_CHARACTERS_TOKENS[static_cast<unsigned char>(c)] != Token::Empty || c == ' ' || c == '\n' || unitSize(index);
+    }
+
+    size_t Lexer::lexeSpace() {
+        size_t i = scanner::skipBlanks(_expression, _index) - _index;
         if (i > 0) {
-            _parsedTree->appendNext(new DeserializationNode(Token::Space));
+            if (_whiteSpaceTokens) appendToken(Token::Space);
+            else _whiteSpacesFlags |= PRECEDED_BY_SPACE;
         }
         return i;
     }
@@ -19,91 +78,68 @@ namespace style {
             i++;
         }
         if (i == 0) return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::LineBreak));
+        if (_whiteSpaceTokens) appendToken(Token::LineBreak);
+        else _whiteSpacesFlags |= PRECEDED_BY_LINE_BREAK;
         return i;
     }
 
     size_t Lexer::lexeOneLineComment() {
-        if (_expression[_index] != '/' || _expression[_index + 1] != '/') return 0;
-        size_t i = 1;
-        while (_index + i + 1 < _expression.size() && _expression[_index + i + 1] != '\n') {
-            i++;
-        }
-        _parsedTree->appendNext(new DeserializationNode(Token::OneLineComment, _expression.substr(_index + 2, i - 1)));
+        if (_expression[_index] != '/' || charAt(_index + 1) != '/') return 0;
+        size_t i = scanner::findCharacter(_expression, _index + 2, '\n') - _index - 1;
+        if (_keepComments) appendToken(Token::OneLineComment, _index + 2, i - 1);
         return i + 1;
     }
 
     size_t Lexer::lexeMultiLineComment() {
         if (_expression[_index] != '/' || _index + 1 == _expression.size() || _expression[_index + 1] != '*') return 0;
-        size_t i = 1;
-        while (_index + i + 2 < _expression.size() && !(_expression[_index + i + 1] == '*' && _expression[_index + i + 2] == '/')) {
-            i++;
-        }
-        if (_index + i + 2 >= _expression.size()) return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::MultiLineComment, _expression.substr(_index + 2, i - 1)));
+        size_t end = scanner::findMultiLineCommentEnd(_expression, _index + 2);
+        if (end == _expression.size()) return 0;
+        size_t i = end - _index - 1;
+        if (_keepComments) appendToken(Token::MultiLineComment, _index + 2, i - 1);
         return i + 3;
     }
 
     size_t Lexer::lexeRawName() {
-        if (!std::isalnum(_expression[_index])) return 0;
+        CharacterClass firstCharacterClass = characterClass(_expression[_index]);
+        if (firstCharacterClass != CharacterClass::Digit && firstCharacterClass != CharacterClass::BoolStart && firstCharacterClass != CharacterClass::Letter)
+            return 0;
         size_t i = 1;
-        while (std::isalnum(_expression[_index + i])
-               || std::find(RAW_NAME_ALLOWED_SPECIAL_CHARACTERS.cbegin(), RAW_NAME_ALLOWED_SPECIAL_CHARACTERS.cend(), _expression[_index + i])
-               != RAW_NAME_ALLOWED_SPECIAL_CHARACTERS.cend()) {
+        while (isRawNameCharacter(charAt(_index + i))) {
             i++;
         }
-        _parsedTree->appendNext(new DeserializationNode(Token::RawName, _expression.substr(_index, i)));
+        appendToken(Token::RawName, _index, i);
         return i;
     }
 
     size_t Lexer::lexeStringDoubleQuotes() {
         if (_expression[_index] != '"') return 0;
-        size_t i = 1;
-        while (_index + i + 1 < _expression.length() && _expression[_index + i + 1] != '"') {
-            i++;
-        }
-        if (i != 1 && (_index + i >= _expression.length() || _expression[_index + i + 1] != '"')) return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::String, (i == 1) ? "" : _expression.substr(_index + 1, i)));
+        size_t i = std::max<size_t>(1, scanner::findCharacter(_expression, _index + 2, '"') - _index - 1);
+        if (i != 1 && (_index + i >= _expression.length() || charAt(_index + i + 1) != '"')) return 0;
+        appendToken(Token::String, _index + 1, (i == 1) ? 0 : i);
         return i + 2;
     }
 
     size_t Lexer::lexeStringSingleQuotes() {
         if (_expression[_index] != '\'') return 0;
-        size_t i = 1;
-        while (_index + i + 1 < _expression.length() && _expression[_index + i + 1] != '\'') {
-            i++;
-        }
-
-        if (i != 1 && (_index + i >= _expression.length() || _expression[_index + i + 1] != '\'')) return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::String, (i == 1) ? "" : _expression.substr(_index + 1, i)));
+        size_t i = std::max<size_t>(1, scanner::findCharacter(_expression, _index + 2, '\'') - _index - 1);
+        if (i != 1 && (_index + i >= _expression.length() || charAt(_index + i + 1) != '\'')) return 0;
+        appendToken(Token::String, _index + 1, (i == 1) ? 0 : i);
         return i + 2;
     }
 
     size_t Lexer::lexeInt() {
         size_t i = 0;
         if (_expression[_index] == '-') i++;
-        if (!isdigit(_expression[_index + i])) return 0;
-        int tmpSize;
+        if (!isdigit(charAt(_index + i))) return 0;
         while (_index + i < _expression.length() && isdigit(_expression[_index + i])) {
             i++;
         }
-        if (_index
-            + i
-            < _expression.length()
-            && RESERVED_CHARACTERS.find(_expression[_index + i])
-            == RESERVED_CHARACTERS.cend()
-            && _expression[_index + i]
-            != ' '
-            && _expression[_index + i]
-            != '\n'
-            && !getUnit(i, &tmpSize).size())
-            return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::Int, _expression.substr(_index, i)));
+        if (!canEndNumber(i)) return 0;
+        appendToken(Token::Int, _index, i);
         return i;
     }
 
     size_t Lexer::lexeFloat() {
-        int tmpSize;
         bool dotFound = false;
         size_t i = 0;
         size_t min_index = 2;
@@ -120,106 +156,267 @@ namespace style {
             i++;
         }
         if (!dotFound || i < min_index) return 0; // need at least one int (0-9) and a dot
-        if (_index
-            + i
-            < _expression.length()
-            && RESERVED_CHARACTERS.find(_expression[_index + i])
-            == RESERVED_CHARACTERS.cend()
-            && _expression[_index + i]
-            != ' '
-            && _expression[_index + i]
-            != '\n'
-            && !getUnit(i, &tmpSize).size())
-            return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::Float, _expression.substr(_index, i)));
+        if (!canEndNumber(i)) return 0;
+        appendToken(Token::Float, _index, i);
         return i;
     }
 
     size_t Lexer::lexeBool() {
+        // substrings of a string_view are only views, so no temporary string is allocated
         if (_expression.substr(_index, TRUE.size()) == TRUE) {
-            _parsedTree->appendNext(new DeserializationNode(Token::Bool, _expression.substr(_index, TRUE.size())));
+            appendToken(Token::Bool, _index, TRUE.size());
             return TRUE.size();
         }
         else if (_expression.substr(_index, FALSE.size()) == FALSE) {
-            _parsedTree->appendNext(new DeserializationNode(Token::Bool, _expression.substr(_index, FALSE.size())));
+            appendToken(Token::Bool, _index, FALSE.size());
             return FALSE.size();
         }
         return 0;
     }
 
-    std::string Lexer::getUnit(int expressionIndex, int *size) {
-        size_t i;
-        bool equal;
-        // TODO: either use config or parse all possible units (need a definition of what a unit can be)
-
-        for (const std::string &unit : _config->units) {
-            equal = true;
-            for (i = 0; i < unit.size(); i++) {
-                if (_expression[_index + expressionIndex + i] != unit[i]) {
-                    equal = false;
-                    break;
-                }
-            }
-            if (equal) {
-                *size = i;
-                return unit;
-            }
-        }
-        *size = 0;
-        return "";
+    size_t Lexer::unitSize(size_t expressionIndex) const {
+        // the units are the ones of the config, compiled in a trie matching the longest one
+        return _units->match(_expression, _index + expressionIndex);
     }
 
     size_t Lexer::lexeUnit() {
-        int size;
-        std::string unit = getUnit(0, &size);
-        if (!unit.size()) return 0;
-        _parsedTree->appendNext(new DeserializationNode(Token::Unit, unit));
+        size_t size = unitSize(0);
+        if (!size) return 0;
+        appendToken(Token::Unit, _index, size);
         return size;
     }
 
     size_t Lexer::lexeReservedCharacters() {
-        std::map<char, Token>::const_iterator specialCharIt = RESERVED_CHARACTERS.find(_expression[_index]);
-        if (specialCharIt == RESERVED_CHARACTERS.cend()) return 0;
-        _parsedTree->appendNext(new DeserializationNode(specialCharIt->second));
+        Token token = RESERVED_CHARACTERS_TOKENS[static_cast<unsigned char>(_expression[_index])];
+        if (token == Token::Empty) return 0;
+        appendToken(token);
         return 1;
     }
 
+    size_t Lexer::lexeToken() {
+        size_t increment = 0;
+        char c = _expression[_index];
+        CharacterClass currentClass = characterClass(c);
+
+        // methods who were tried before lexeUnit
+        switch (currentClass) {
+        case CharacterClass::Space:
+            return lexeSpace();
+        case CharacterClass::LineBreak:
+            return lexeLineReturn();
+        case CharacterClass::Slash:
+            increment = lexeOneLineComment();
+            if (!increment) increment = lexeMultiLineComment();
+            break;
+        case CharacterClass::DoubleQuote:
+            increment = lexeStringDoubleQuotes();
+            break;
+        case CharacterClass::SingleQuote:
+            increment = lexeStringSingleQuotes();
+            break;
+        case CharacterClass::Minus:
+        case CharacterClass::Digit:
+            increment = lexeFloat();
+            if (!increment) increment = lexeInt();
+            break;
+        case CharacterClass::Dot:
+            increment = lexeFloat();
+            break;
+        case CharacterClass::BoolStart:
+            increment = lexeBool();
+            break;
+        default:
+            break;
+        }
+        if (increment) return increment;
+
+        if (_units->canStartUnit(c)) increment = lexeUnit();
+        if (increment) return increment;
+
+        // methods who were tried after lexeUnit
+        switch (currentClass) {
+        case CharacterClass::Digit:
+        case CharacterClass::BoolStart:
+        case CharacterClass::Letter:
+            return lexeRawName();
+        case CharacterClass::Dot:
+        case CharacterClass::Reserved:
+            return lexeReservedCharacters();
+        default:
+            return 0;
+        }
+    }
+
     DeserializationNode *Lexer::lexe(const std::string &expression, const config::Config *config) {
-        _expression = expression;
+        return lexeTokens(expression, config).toNodes(false);
+    }
+
+    DeserializationNode *Lexer::lexeInPlace(std::string_view expression, const config::Config *config) {
+        return lexeTokens(expression, config).toNodes(true);
+    }
+
+    void Lexer::setConfig(const config::Config *config) {
         _config = config;
-        DeserializationNode *firstNode = new DeserializationNode(Token::NullRoot);
-        _parsedTree = firstNode;
+        _units = &_ownUnits;
+        if (_config->units == _unitNames) return;
+        _unitNames = _config->units;
+        _ownUnits = UnitMatcher(_unitNames);
+    }
+
+    void Lexer::setConfig(const config::CompiledConfig *config) {
+        _config = config->config();
+        _units = &config->units();
+    }
+
+    void Lexer::reset() {
+        _index = 0;
+        _whiteSpacesFlags = 0;
+        _expression = "";
+        _tokens.reset(_expression);
+        _read = nullptr;
+        _window.clear();
+        _endOfInput = true;
+    }
+
+    const TokenStream &Lexer::lexeTokens(std::string_view expression, const config::Config *config) {
+        if (expression.size() > UINT32_MAX) throw ExpressionTooLarge(expression.size());
+        reset();
+        _expression = expression;
+        _tokens.reset(expression);
+        setConfig(config);
         size_t increment;
 
         while (_index < expression.length()) {
-            increment = lexeSpace();
-            if (!increment) increment = lexeLineReturn();
-            if (!increment) increment = lexeOneLineComment();
-            if (!increment) increment = lexeMultiLineComment();
-            if (!increment) increment = lexeStringDoubleQuotes();
-            if (!increment) increment = lexeStringSingleQuotes();
-            if (!increment) increment = lexeFloat();
-            if (!increment) increment = lexeInt();
-            if (!increment) increment = lexeBool();
-            if (!increment) increment = lexeUnit();
-            if (!increment) increment = lexeRawName();
-            if (!increment) increment = lexeReservedCharacters();
-            if (!increment) {
-                delete firstNode;
-                firstNode = nullptr;
-                throw UnknownValue(expression.substr(_index, MAX_ERROR_COMPLEMENTARY_INFOS_SIZE));
-            }
+#ifdef DEBUG
+            size_t tokensCount = _tokens.size();
+#endif
+            increment = lexeToken();
+            if (!increment) throw UnknownValue(std::string(expression.substr(_index, MAX_ERROR_COMPLEMENTARY_INFOS_SIZE)));
             _index += increment;
 #ifdef DEBUG
-            std::clog << tokenToString(_parsedTree->token()) << ": '" << _parsedTree->value() << "'\n";
+            // skipped comments and white spaces lexed as flags don't add a token
+            if (_tokens.size() > tokensCount) std::clog << tokenToString(_tokens.back().token) << ": '" << _tokens.value(_tokens.back()) << "'\n";
 #endif
-            _parsedTree = _parsedTree->next();
         }
-        // remove the NullRoot token at the start
-        DeserializationNode *nextList = firstNode->next();
-        firstNode->next(nullptr);
-        delete firstNode;
-        return nextList;
+        return _tokens;
+    }
+
+    void Lexer::startExpression(std::string_view expression) {
+        if (expression.size() > UINT32_MAX) throw ExpressionTooLarge(expression.size());
+        reset();
+        _expression = expression;
+        _tokens.reset(expression);
+    }
+
+    void Lexer::start(std::string_view expression, const config::Config *config) {
+        startExpression(expression);
+        setConfig(config);
+    }
+
+    void Lexer::start(std::string_view expression, const config::CompiledConfig *config) {
+        startExpression(expression);
+        setConfig(config);
+    }
+
+    bool Lexer::nextToken(LexedToken *token) {
+        if (streams()) return nextStreamedToken(token);
+        size_t increment;
+        _tokens.clear();
+        while (_index < _expression.length()) {
+            increment = lexeToken();
+            if (!increment) throw UnknownValue(std::string(_expression.substr(_index, MAX_ERROR_COMPLEMENTARY_INFOS_SIZE)));
+            _index += increment;
+            // skipped comments and white spaces lexed as flags don't add a token
+            if (!_tokens.empty()) {
+                *token = _tokens.back();
+#ifdef DEBUG
+                std::clog << tokenToString(token->token) << ": '" << _tokens.value(*token) << "'\n";
+#endif
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Lexer::startStream(const ReadCallback &read, const config::CompiledConfig *config, size_t chunkSize) {
+        reset();
+        setConfig(config);
+        startStream(read, chunkSize);
+    }
+
+    void Lexer::startStream(const ReadCallback &read, size_t chunkSize) {
+        _read = read;
+        _chunkSize = std::max<size_t>(chunkSize, 1);
+        _lookahead = _units->maxUnitSize() + 1;
+        _endOfInput = false;
+        _expression = _window;
+        _tokens.reset(_window);
+    }
+
+    bool Lexer::nextStreamedToken(LexedToken *token) {
+        uint8_t whiteSpacesFlags;
+        size_t increment;
+        _tokens.clear();
+
+        while (true) {
+            if (_index < _window.size()) {
+                whiteSpacesFlags = _whiteSpacesFlags;
+                increment = lexeToken();
+                // a token reaching the end of the window could continue in the next chunk, so it is lexed again with more characters
+                if (_endOfInput || (increment && _index + increment + _lookahead <= _window.size())) {
+                    if (!increment) throw UnknownValue(_window.substr(_index, MAX_ERROR_COMPLEMENTARY_INFOS_SIZE));
+                    _index += increment;
+                    // skipped comments and white spaces lexed as flags don't add a token
+                    if (!_tokens.empty()) {
+                        *token = _tokens.back();
+#ifdef DEBUG
+                        std::clog << tokenToString(token->token) << ": '" << _tokens.value(*token) << "'\n";
+#endif
+                        return true;
+                    }
+                    continue;
+                }
+                _tokens.clear();
+                _whiteSpacesFlags = whiteSpacesFlags;
+            }
+            else if (_endOfInput) return false;
+
+            // read at least as many characters as the window already contains, so a token longer than a chunk is lexed in linear time
+            _window.erase(0, _index);
+            _index = 0;
+            size_t windowSize = _window.size();
+            size_t readSize = std::max(_chunkSize, windowSize);
+            _window.resize(windowSize + readSize);
+            size_t readCount = _read(_window.data() + windowSize, readSize);
+            _window.resize(windowSize + readCount);
+            if (!readCount) _endOfInput = true;
+            if (_window.size() > UINT32_MAX) throw ExpressionTooLarge(_window.size());
+            _expression = _window;
+            _tokens.reset(_window);
+        }
+    }
+
+    TokenStream Lexer::lexeStream(const ReadCallback &read, const config::Config *config, size_t chunkSize) {
+        TokenStream tokens = TokenStream::owningValues();
+        reset();
+        setConfig(config);
+        startStream(read, chunkSize);
+        LexedToken token;
+        while (nextStreamedToken(&token)) {
+            if (tokens.expression().size() + token.length > UINT32_MAX) throw ExpressionTooLarge(tokens.expression().size() + token.length);
+            tokens.pushValue(token, value(token));
+        }
+        reset();
+        return tokens;
+    }
+
+    TokenStream Lexer::lexeStream(std::istream &input, const config::Config *config, size_t chunkSize) {
+        return lexeStream(
+            [&input](char *buffer, size_t size) {
+                input.read(buffer, size);
+                return static_cast<size_t>(input.gcount());
+            },
+            config, chunkSize);
     }
 
 } // namespace style
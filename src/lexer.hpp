@@ -2,14 +2,23 @@
 #define TOKENIZER_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <istream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
 #include "deserialization_node.hpp"
+#include "token_stream.hpp"
+#include "unit_matcher.hpp"
 
 constexpr int MAX_ERROR_COMPLEMENTARY_INFOS_SIZE = 20;
+constexpr size_t DEFAULT_STREAM_CHUNK_SIZE = 64 * 1024;
 
 namespace style {
 
@@ -26,6 +35,11 @@ namespace style {
         UnknownValue(const std::string &value) : LexerException{"Error : Unknown value '" + value + "'"} {};
     };
 
+    class ExpressionTooLarge : public LexerException {
+    public:
+        ExpressionTooLarge(size_t size) : LexerException{"Error : Expression of " + std::to_string(size) + " bytes is too large to be lexed"} {};
+    };
+
     const std::map<char, Token> RESERVED_CHARACTERS = {{'(', Token::OpeningParenthesis},
                                                        {')', Token::ClosingParenthesis},
                                                        {'{', Token::OpeningCurlyBracket},
@@ -42,14 +56,140 @@ namespace style {
 
     const std::vector<char> RAW_NAME_ALLOWED_SPECIAL_CHARACTERS = {'-', '_'};
 
+    /**
+     * Class of the first character of a token, used to directly find which lexing methods can match it
+     */
+    enum class CharacterClass : uint8_t {
+        Space,       // ' ' and '\t'
+        LineBreak,   // '\n'
+        Slash,       // comments
+        DoubleQuote, // strings
+        SingleQuote, // strings
+        Minus,       // negative numbers
+        Dot,         // floats or reserved character
+        Digit,       // numbers or raw names
+        BoolStart,   // 't' and 'f', bools or raw names
+        Letter,      // raw names
+        Reserved,    // every other reserved character
+        Underscore,  // can't start a token but can be inside raw names
+        Other,
+    };
+
+    extern const std::array<CharacterClass, 256> CHARACTER_CLASSES;
+    // Token::Empty for non reserved characters
+    extern const std::array<Token, 256> RESERVED_CHARACTERS_TOKENS;
+
+    /**
+     * Read at most size characters in buffer and return the number of characters read, 0 at the end of the input
+     */
+    using ReadCallback = std::function<size_t(char *buffer, size_t size)>;
+
     class Lexer {
         const config::Config *_config = nullptr;
+        // if false, comments are skipped without adding any token
+        bool _keepComments;
+        // if false, white spaces and line breaks are flags of the next token instead of tokens
+        bool _whiteSpaceTokens;
+        // white spaces lexed since the last token, when _whiteSpaceTokens is false
+        uint8_t _whiteSpacesFlags = 0;
         size_t _index = 0;
-        std::string _expression = "";
-        DeserializationNode *_parsedTree = nullptr;
+        std::string_view _expression = "";
+        TokenStream _tokens;
+        // compiled from the config units, kept until a config with other units is given
+        UnitMatcher _ownUnits;
+        std::vector<std::string> _unitNames;
+        // _ownUnits, or the units of a CompiledConfig
+        const UnitMatcher *_units = &_ownUnits;
+        // in stream pull mode (see startStream), reads the input by chunks in _window, the characters already lexed being dropped
+        ReadCallback _read;
+        std::string _window;
+        size_t _chunkSize = DEFAULT_STREAM_CHUNK_SIZE;
+        // number of characters after a token who can change how it is lexed (the end of a number is checked against the units)
+        size_t _lookahead = 0;
+        bool _endOfInput = true;
+
+        // return '\0' if outside of the expression
+        char charAt(size_t index) const { return index < _expression.size() ? _expression[index] : '\0'; }
+        static CharacterClass characterClass(char c) { return CHARACTER_CLASSES[static_cast<unsigned char>(c)]; }
+        static bool isRawNameCharacter(char c);
+        // a number must be followed by a reserved character, a space, a line break, an unit or the end of the expression
+        bool canEndNumber(size_t index);
+        /**
+         * Dispatch on the class of the current character to the only lexing methods who can match it,
+         * in the same order as they would be tried one after an other.
+         */
+        size_t lexeToken();
+        void appendToken(Token token, size_t start = 0, size_t length = 0) {
+            _tokens.push(token, start, length, _whiteSpacesFlags);
+            _whiteSpacesFlags = 0;
+        }
+        void setConfig(const config::Config *config);
+        void setConfig(const config::CompiledConfig *config);
+        // start the pull mode on the expression, before setting the config
+        void startExpression(std::string_view expression);
+        // start the stream pull mode with the config already set
+        void startStream(const ReadCallback &read, size_t chunkSize);
+        // nextToken in stream pull mode
+        bool nextStreamedToken(LexedToken *token);
 
     public:
+        /**
+         * Comments are only needed by tools working on the style files themselves, since the parser ignores them.
+         * Without white space tokens, the parser only needs to know whether a token is preceded by white spaces (LexedToken::flags),
+         * and the white spaces at the end of the expression are dropped.
+         */
+        Lexer(bool keepComments = false, bool whiteSpaceTokens = true) : _keepComments{keepComments}, _whiteSpaceTokens{whiteSpaceTokens} {}
+        /**
+         * Forget the expression being lexed, so the lexer can be used again after an exception or in the middle of a pull mode lexing.
+         * The memory of the tokens and the compiled units are kept, lexing many small expressions with the same lexer doesn't allocate.
+         */
+        void reset();
+        /**
+         * Lexe the expression in a contiguous list of tokens.
+         * The returned stream is the one of the lexer, whose memory is reused by the next lexing: it is valid until the lexer is used
+         * again, and must be copied to be kept. The expression must outlive the returned stream.
+         */
+        const TokenStream &lexeTokens(std::string_view expression, const config::Config *config);
+        /**
+         * Pull mode: prepare the lexing of the expression, whose tokens are then lexed one at a time by nextToken.
+         * The expression must outlive the tokens.
+         */
+        void start(std::string_view expression, const config::Config *config);
+        /**
+         * Same as start, with the units compiled once in the config
+         */
+        void start(std::string_view expression, const config::CompiledConfig *config);
+        /**
+         * Pull mode on an input read by chunks of chunkSize characters, whose tokens are then lexed one at a time by nextToken.
+         * Only the characters of the tokens not lexed yet are kept in memory.
+         */
+        void startStream(const ReadCallback &read, const config::CompiledConfig *config, size_t chunkSize = DEFAULT_STREAM_CHUNK_SIZE);
+        bool streams() const { return _read != nullptr; }
+        /**
+         * Lexe the next token of the expression given to start, return false at the end of the expression
+         */
+        bool nextToken(LexedToken *token);
+        /**
+         * Value of the last token returned by nextToken, valid until the next call.
+         * In stream pull mode, its start is an index in the characters of the input kept in memory, not in the whole input.
+         */
+        std::string_view value(const LexedToken &token) const { return _tokens.value(token); }
+        /**
+         * Same as lexeTokens, but returns a chain of nodes.
+         * Each token owns a copy of its value, so the expression can be freed after the call.
+         */
         DeserializationNode *lexe(const std::string &expression, const config::Config *config);
+        /**
+         * Zero-copy lexing: each token value is a span of the expression.
+         * The expression must outlive the tokens and every node created from them (including the parser's tree).
+         */
+        DeserializationNode *lexeInPlace(std::string_view expression, const config::Config *config);
+        /**
+         * Lexe an input read by chunks of chunkSize characters, giving the same tokens as lexeTokens on the whole input.
+         * Only the characters of the token being lexed are kept in memory, the returned stream owns the values of its tokens.
+         */
+        TokenStream lexeStream(const ReadCallback &read, const config::Config *config, size_t chunkSize = DEFAULT_STREAM_CHUNK_SIZE);
+        TokenStream lexeStream(std::istream &input, const config::Config *config, size_t chunkSize = DEFAULT_STREAM_CHUNK_SIZE);
         size_t lexeSpace();
         size_t lexeLineReturn();
         size_t lexeOneLineComment();
@@ -60,7 +200,10 @@ namespace style {
         size_t lexeInt();
         size_t lexeFloat();
         size_t lexeBool();
-        std::string getUnit(int expressionIndex, int *size);
+        /**
+         * Size of the longest unit at _index + expressionIndex, 0 if there is none
+         */
+        size_t unitSize(size_t expressionIndex) const;
         size_t lexeUnit();
         size_t lexeReservedCharacters();
     };
@@ -0,0 +1,71 @@
+#include "node_arena.hpp"
+#include <cstring>
+
+namespace style {
+
+    namespace {
+        thread_local NodeArena *currentArena = nullptr;
+
+        constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+    } // namespace
+
+    void *NodeArena::allocate(size_t size) {
+        size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        if (size > _remaining) {
+            // a bigger allocation gets its own block, so the current one is not wasted
+            if (size > BLOCK_SIZE / 4) {
+                _largeBlocks.push_back(static_cast<char *>(::operator new(size)));
+                return _largeBlocks.back();
+            }
+            if (_usedBlocks == _blocks.size()) _blocks.push_back(static_cast<char *>(::operator new(BLOCK_SIZE)));
+            _current = _blocks[_usedBlocks++];
+            _remaining = BLOCK_SIZE;
+        }
+        void *memory = _current;
+        _current += size;
+        _remaining -= size;
+        return memory;
+    }
+
+    std::string_view NodeArena::copy(std::string_view value) {
+        if (value.empty()) return std::string_view();
+        char *memory = static_cast<char *>(allocate(value.size()));
+        std::memcpy(memory, value.data(), value.size());
+        return std::string_view(memory, value.size());
+    }
+
+    NodeArena *NodeArena::newChild() {
+        std::lock_guard<std::mutex> lock(_childrenMutex);
+        _children.push_back(new NodeArena());
+        return _children.back();
+    }
+
+    void NodeArena::release() {
+        reset();
+        for (char *block : _blocks) {
+            ::operator delete(block);
+        }
+        _blocks.clear();
+    }
+
+    void NodeArena::reset() {
+        for (char *block : _largeBlocks) {
+            ::operator delete(block);
+        }
+        _largeBlocks.clear();
+        _usedBlocks = 0;
+        _current = nullptr;
+        _remaining = 0;
+        for (NodeArena *child : _children) {
+            delete child;
+        }
+        _children.clear();
+    }
+
+    NodeArena *NodeArena::current() { return currentArena; }
+
+    NodeArena::Scope::Scope(NodeArena *arena) : _previous{currentArena} { currentArena = arena; }
+
+    NodeArena::Scope::~Scope() { currentArena = _previous; }
+
+} // namespace style
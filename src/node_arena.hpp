@@ -0,0 +1,77 @@
+#ifndef NODE_ARENA_HPP
+#define NODE_ARENA_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace style {
+
+    /**
+     * Monotonic memory pool for the nodes of a temporary tree.
+     * While an arena is the current one of a thread, the nodes created by the thread are allocated in it,
+     * deleting them doesn't free anything and the whole memory is released at once by release,
+     * without deleting the nodes one by one.
+     */
+    class NodeArena {
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        // blocks of BLOCK_SIZE, the first _usedBlocks ones are the ones allocated in since the last reset
+        std::vector<char *> _blocks;
+        size_t _usedBlocks = 0;
+        // blocks of the allocations too big to share a block
+        std::vector<char *> _largeBlocks;
+        char *_current = nullptr;
+        size_t _remaining = 0;
+        // arenas of the other threads allocating nodes for the same tree
+        std::vector<NodeArena *> _children;
+        std::mutex _childrenMutex;
+
+    public:
+        NodeArena() = default;
+        NodeArena(const NodeArena &) = delete;
+        NodeArena &operator=(const NodeArena &) = delete;
+        ~NodeArena() { release(); }
+
+        /**
+         * Memory aligned for any type, valid until release
+         */
+        void *allocate(size_t size);
+        /**
+         * Copy of the value in the arena, so a node can reference it instead of owning a string
+         */
+        std::string_view copy(std::string_view value);
+        /**
+         * Arena for an other thread, released with this one
+         */
+        NodeArena *newChild();
+        /**
+         * Free all the memory of the arena, the nodes allocated in it must not be used anymore
+         */
+        void release();
+        /**
+         * Same as release, but the blocks are kept to be allocated in again, so an arena used for many small trees stops allocating
+         */
+        void reset();
+
+        // nullptr if the nodes are allocated on the heap
+        static NodeArena *current();
+
+        /**
+         * Make an arena the current one of the thread until the end of the scope
+         */
+        class Scope {
+            NodeArena *_previous;
+
+        public:
+            Scope(NodeArena *arena);
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+            ~Scope();
+        };
+    };
+
+} // namespace style
+
+#endif // NODE_ARENA_HPP
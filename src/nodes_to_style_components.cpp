@@ -1,12 +1,12 @@
 #include "nodes_to_style_components.hpp"
 #include "lexer.hpp"
+#include "parallel_parser.hpp"
 #include "parser.hpp"
 #include "style_component.hpp"
 #include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iterator>
-#include <sstream>
 
 namespace style {
 
@@ -52,6 +52,31 @@ namespace style {
         }
     }
 
+    Token styleValueTypeToTokenType(StyleValueType type) {
+        switch (type) {
+        case StyleValueType::Int:
+            return Token::Int;
+        case StyleValueType::Float:
+            return Token::Float;
+        case StyleValueType::Bool:
+            return Token::Bool;
+        case StyleValueType::String:
+            return Token::String;
+        case StyleValueType::Tuple:
+            return Token::Tuple;
+        case StyleValueType::Function:
+            return Token::Function;
+        case StyleValueType::Unit:
+            return Token::Unit;
+        case StyleValueType::Hex:
+            return Token::Hex;
+        case StyleValueType::EnumValue:
+            return Token::EnumValue;
+        default:
+            return Token::NullRoot;
+        }
+    }
+
     StyleRelation tokenTypeToStyleRelation(Token token) {
         switch (token) {
         case Token::DirectParent:
@@ -65,79 +90,64 @@ namespace style {
         }
     }
 
-    DeserializationNode *NodesToStyleComponents::deserializeStyle(const std::string &style) {
-        DeserializationNode *tokens = nullptr;
-        DeserializationNode *result = nullptr;
-        try {
-            config::configChecker(_config);
-            tokens = Lexer().lexe(style, _config);
-            result = Parser().parse(tokens);
-            delete tokens;
-            return result;
-        }
-        catch (const ParserException &) {
-            delete tokens;
-            throw;
-        }
-        catch (const LexerException &) {
-            delete tokens;
-            throw;
-        }
+    NodesToStyleComponents::NodesToStyleComponents(const config::Config *config) : _ownedConfig{new config::CompiledConfig(config)} {
+        _config = _ownedConfig;
+    }
+
+    NodesToStyleComponents::~NodesToStyleComponents() { delete _ownedConfig; }
+
+    DeserializationNode *NodesToStyleComponents::deserializeStyle(std::string_view style) { return parser.parse(style, _config); }
+
+    DeserializationNode *NodesToStyleComponents::deserializeStyle(std::istream &style) { return parser.parse(style, _config); }
+
+    DeserializationNode *NodesToStyleComponents::deserializeStyleInParallel(std::string_view style, unsigned int threadsCount) {
+        return ParallelParser(threadsCount).parse(style, _config);
     }
 
     DeserializationNode *NodesToStyleComponents::deserializeStyleFromFile(const std::string &fileName) {
         std::ifstream file(fileName);
-        std::stringstream buffer;
         if (!file.is_open()) {
             std::cerr << "File '" << fileName << "' couldn't be opened\n";
             return nullptr;
         }
-        buffer << file.rdbuf();
-        return deserializeStyle(buffer.str());
-    }
-
-    DeserializationNode *NodesToStyleComponents::joinStyleDeclarations(DeserializationNode *firstDeclarations,
-                                                                       DeserializationNode *secondDeclarations) {
-        DeserializationNode *newDeclarations = new DeserializationNode(Token::NullRoot);
-        DeserializationNode *actualDeclaration;
-        DeserializationNode *secondDeclarationsIt;
-
-        while (firstDeclarations != nullptr) {
-            secondDeclarationsIt = secondDeclarations;
-            while (secondDeclarationsIt != nullptr) {
-                actualDeclaration = newDeclarations->appendNext(firstDeclarations->copyNodeWithChilds());
-                if (tokenTypeToStyleRelation(secondDeclarationsIt->child()->token()) == StyleRelation::Null)
-                    actualDeclaration->addChild(new DeserializationNode(Token::AnyParent));
-                if (tokenTypeToStyleRelation(secondDeclarationsIt->child()->token()) == StyleRelation::SameElement)
-                    secondDeclarationsIt->deleteSpecificChild(secondDeclarationsIt->child());
-                actualDeclaration->addChild(secondDeclarationsIt->child()->copyNodeWithChildsAndNexts());
-                secondDeclarationsIt = secondDeclarationsIt->next();
+        return deserializeStyle(file);
+    }
+
+    std::vector<NodesToStyleComponents::SelectorParts> NodesToStyleComponents::selectorsParts(const DeserializationNode *blockSelectors) {
+        std::vector<SelectorParts> selectors;
+        for (const DeserializationNode *selector = blockSelectors->child(); selector != nullptr; selector = selector->next()) {
+            selectors.emplace_back();
+            for (const DeserializationNode *part = selector->child(); part != nullptr; part = part->next()) {
+                selectors.back().emplace_back(part->token(), part->value());
             }
-            firstDeclarations = firstDeclarations->next();
         }
+        return selectors;
+    }
 
-        DeserializationNode *root = newDeclarations;
-        newDeclarations = newDeclarations->next();
-        root->next(nullptr);
-        delete root;
-        return newDeclarations;
+    const NodesToStyleComponents::SelectorsGroup *NodesToStyleComponents::selectorsGroup(const DeserializationNode *block) {
+        std::unordered_map<const DeserializationNode *, const SelectorsGroup *>::const_iterator group = blocksSelectors.find(block);
+        if (group != blocksSelectors.cend()) return group->second;
+        selectorsGroups.push_back({nullptr, selectorsParts(block->child())});
+        blocksSelectors.emplace(block, &selectorsGroups.back());
+        return &selectorsGroups.back();
     }
 
     void NodesToStyleComponents::moveNestedBlocksToRoot(DeserializationNode *style) {
-        DeserializationNode *blockDeclarations = style->child();
-        DeserializationNode *content = blockDeclarations->next()->child();
+        DeserializationNode *content = style->child()->next()->child();
         DeserializationNode *nextDeclaration;
+        DeserializationNode *position = style;
+        const SelectorsGroup *group = nullptr;
 
         while (content != nullptr) {
             if (content->token() == Token::StyleBlock) {
-                content->child()->replaceChild(content->child()->child(),
-                                               joinStyleDeclarations(blockDeclarations->child(), content->child()->child()));
+                // the selectors of the nested block reference the ones of the block instead of being joined to copies of them
+                if (group == nullptr) group = selectorsGroup(style);
+                selectorsGroups.push_back({group, selectorsParts(content->child())});
+                blocksSelectors.emplace(content, &selectorsGroups.back());
                 nextDeclaration = content->next();
                 content->parent()->removeSpecificChild(content);
-                content->next(style->next());
-                style->next(content);
-                content->setParent(style->parent());
-                style = content;
+                position->parent()->insertChildsAfter(position, content);
+                position = content;
                 content = nextDeclaration;
                 continue;
             }
@@ -147,43 +157,51 @@ namespace style {
 
     void NodesToStyleComponents::flattenStyle(DeserializationNode *style) {
         if (style == nullptr) return;
+        DeserializationNode *root = style;
         style = style->child();
         while (style != nullptr) {
             if (style->token() == Token::StyleBlock) moveNestedBlocksToRoot(style);
             else if (style->token() == Token::Import) {
-                DeserializationNode *importedStyle = deserializeStyleFromFile(style->value()); // refactor with StyleManager
+                DeserializationNode *importedStyle = deserializeStyleFromFile(std::string(style->value())); // refactor with StyleManager
                 if (importedStyle != nullptr) {
-                    importedStyle->addChild(style->next());
-                    style->next(importedStyle->child());
-                    importedStyle->setChild(nullptr);
+                    DeserializationNode *importedBlocks = importedStyle->child();
+                    importedStyle->removeChilds();
                     delete importedStyle;
+                    root->insertChildsAfter(style, importedBlocks);
                 }
             }
             style = style->next();
         }
     }
 
-    bool NodesToStyleComponents::ruleNodesValid(const DeserializationNode *ruleNode, const config::ConfigRuleNode *configNode) {
-        if (ruleNode == nullptr && configNode == nullptr) return true;
-        if (ruleNode == nullptr || configNode == nullptr) return false;
-        if (ruleNode->token() != configNode->token()) return false;
-        if (configNode->token() == Token::EnumValue) {
-            const std::set<std::string> &allowedValues = static_cast<const config::ConfigRuleNodeEnum *>(configNode)->allowedValues();
-            return allowedValues.find(ruleNode->value()) != allowedValues.cend();
-        }
-        return true;
-    }
-
     bool NodesToStyleComponents::ruleValid(const DeserializationNode *rule) {
         const DeserializationNode *ruleName = rule->child();
-        const DeserializationNode *ruleValue = ruleName->next();
-        std::unordered_map<std::string, std::vector<const config::ConfigRuleNode *>>::const_iterator configRules =
-            _config->rules.find(ruleName->value());
-        if (configRules == _config->rules.cend()) return false;
-        for (const config::ConfigRuleNode *configRule : configRules->second) {
-            if (ruleNodesValid(ruleValue, configRule)) return true;
+        const DeserializationNode *node = ruleName->next();
+        uint32_t ruleId = _config->ruleId(ruleName->value());
+        if (ruleId == config::CompiledConfig::NO_RULE) return false;
+        auto isValue = [](const DeserializationNode *node) {
+            return node != nullptr && tokenTypeToStyleValueType(node->token()) != StyleValueType::Null;
+        };
+        ruleMatch.start(&_config->ruleMatcher(ruleId));
+        ruleValueParents.clear();
+        // the nodes converted to the value, in pre-order
+        while (node != nullptr) {
+            ruleMatch.open(node->token(), node->value());
+            if (ruleMatch.failed()) return false;
+            if (isValue(node->child())) {
+                ruleValueParents.push_back(node);
+                node = node->child();
+                continue;
+            }
+            ruleMatch.close();
+            while (!isValue(node->next()) && !ruleValueParents.empty()) {
+                node = ruleValueParents.back();
+                ruleValueParents.pop_back();
+                ruleMatch.close();
+            }
+            node = isValue(node->next()) ? node->next() : nullptr;
         }
-        return false;
+        return ruleMatch.matched();
     }
 
     void NodesToStyleComponents::filterRulesWithConfiguration(DeserializationNode *style) {
@@ -207,11 +225,10 @@ namespace style {
 #ifdef DEBUG
                     std::cerr << "invalid rule:\n";
                     rule->debugDisplay();
-                    std::unordered_map<std::string, std::vector<const config::ConfigRuleNode *>>::const_iterator configRules =
-                        _config->rules.find(rule->child()->value());
-                    if (configRules != _config->rules.cend()) {
+                    uint32_t ruleId = _config->ruleId(rule->child()->value());
+                    if (ruleId != config::CompiledConfig::NO_RULE) {
                         std::cerr << "available config rules:\n";
-                        for (const config::ConfigRuleNode *configRule : configRules->second) {
+                        for (const config::ConfigRuleNode *configRule : _config->ruleNodes(ruleId)) {
                             configRule->debugDisplay();
                         }
                     }
@@ -287,20 +304,33 @@ namespace style {
     }
 
     StyleValue *NodesToStyleComponents::convertStyleNodeToStyleValue(DeserializationNode *node) {
-        if (node == nullptr) return nullptr;
-        StyleValueType type;
-        StyleValue *styleValue;
-        StyleValue *styleNext;
-
-        type = tokenTypeToStyleValueType(node->token());
-        if (type == StyleValueType::Null) return nullptr;
-
-        styleValue = new StyleValue(node->value(), type);
-
-        styleValue->addChild(convertStyleNodeToStyleValue(node->child()));
-
-        styleNext = convertStyleNodeToStyleValue(node->next());
-        if (styleNext != nullptr) styleValue->next(styleNext);
+        // converted nodes whose childs are still to be converted, in an explicit stack so a long tuple or a deep value can't overflow it
+        std::vector<std::pair<const DeserializationNode *, StyleValue *>> pendingNodes;
+        std::pair<const DeserializationNode *, StyleValue *> pending;
+        // convert a node and its nexts, up to the first one who isn't a value
+        auto convertNexts = [&pendingNodes](const DeserializationNode *node, StyleValue *parent) {
+            StyleValue *first = nullptr;
+            StyleValue *last = nullptr;
+            StyleValueType type;
+            for (; node != nullptr && (type = tokenTypeToStyleValueType(node->token())) != StyleValueType::Null; node = node->next()) {
+                // the value is only copied out of the source here
+                StyleValue *styleValue = new StyleValue(std::string(node->value()), type);
+                styleValue->number(node->number());
+                styleValue->parent(parent);
+                if (last == nullptr) first = styleValue;
+                else last->next(styleValue);
+                last = styleValue;
+                pendingNodes.emplace_back(node, styleValue);
+            }
+            return first;
+        };
+
+        StyleValue *styleValue = convertNexts(node, nullptr);
+        while (!pendingNodes.empty()) {
+            pending = pendingNodes.back();
+            pendingNodes.pop_back();
+            pending.second->addChild(convertNexts(pending.first->child(), pending.second));
+        }
         return styleValue;
     }
 
@@ -329,7 +359,7 @@ namespace style {
                 if (!isNodeNull(ruleNameNode)) {
                     styleValue = convertStyleNodeToStyleValue(ruleNameNode);
                     if (styleValue != nullptr) {
-                        (*appliedStyleMap).insert_or_assign(ruleName, StyleRule(styleValue, true, 0, fileNumber, *ruleNumber));
+                        (*appliedStyleMap).insert_or_assign(ruleName, StyleRule(styleValue, true, fileNumber, *ruleNumber));
                         delete styleValue;
                         (*ruleNumber)++;
                     }
@@ -348,44 +378,6 @@ namespace style {
         return appliedStyleMap;
     }
 
-    std::list<StyleDefinition *> *
-    NodesToStyleComponents::createStyleComponents(std::list<std::list<StyleComponentDataList *> *>::const_iterator componentsListIt,
-                                                  StyleComponentDataList *components, StyleValuesMap *appliedStyleMap) {
-        if (components == nullptr) return nullptr;
-        std::list<StyleDefinition *> *styleComponentList = new std::list<StyleDefinition *>();
-        std::list<StyleDefinition *> *tmpStyleComponentList;
-        StyleComponentDataList::const_iterator componentsIt;
-        if (std::next(componentsListIt) == requiredStyleComponentsLists.cend()) { // if at end of the declaration list
-            for (StyleComponentDataList *componentsDataList : **componentsListIt) {
-                componentsIt = std::prev(components->end());
-                // appliedStyleMap[0]->second.value._value is modified on the next line
-                // is it because the memory was freed (but still used because of an invalid pointer) and this line is when this memory is reused
-                // elsewhere? or a memory overflow?
-                std::copy(componentsDataList->begin(), componentsDataList->end(), std::back_inserter(*components));
-                int specificity = computeRuleSpecifity(components);
-                for (std::pair<const std::string, StyleRule> &rule : *appliedStyleMap) {
-                    rule.second.specificity = specificity;
-                }
-                styleComponentList->push_back(new StyleDefinition(*components, *appliedStyleMap));
-                if (componentsIt == components->end()) components->clear();
-                else components->erase(componentsIt, components->end());
-            }
-        }
-        else {
-            for (StyleComponentDataList *componentsList : **componentsListIt) {
-                componentsIt = std::prev(components->end());
-                std::copy(componentsList->begin(), componentsList->end(), std::back_inserter(*components));
-                tmpStyleComponentList = createStyleComponents(std::next(componentsListIt), components, appliedStyleMap);
-                if (tmpStyleComponentList != nullptr) {
-                    styleComponentList->splice(styleComponentList->end(), *tmpStyleComponentList);
-                    delete tmpStyleComponentList;
-                }
-                components->erase(componentsIt, components->end());
-            }
-        }
-        return styleComponentList;
-    }
-
     int NodesToStyleComponents::computeRuleSpecifity(StyleComponentDataList *ruleComponents) {
         int specificity = 0;
         for (std::pair<StyleComponentData, StyleRelation> component : *ruleComponents) {
@@ -409,10 +401,13 @@ namespace style {
 
     void NodesToStyleComponents::convertStyleDefinition(int fileNumber, int *ruleNumber) {
         std::list<StyleComponentDataList *> *styleComponentsLists;
+        std::unordered_map<const DeserializationNode *, const SelectorsGroup *>::const_iterator group;
         if (tree == nullptr || tree->token() != Token::StyleBlock) return;
+        group = blocksSelectors.find(tree);
         tree = tree->child();
 
-        styleComponentsLists = convertStyleComponents();
+        // the selectors of a block moved to the root are joined to the ones of its parents only now
+        styleComponentsLists = (group == blocksSelectors.cend()) ? convertStyleComponents() : expandSelectors(*group->second);
         if (styleComponentsLists == nullptr || styleComponentsLists->empty()) {
             delete styleComponentsLists;
             return;
@@ -427,28 +422,279 @@ namespace style {
             return;
         }
 
-        requiredStyleComponentsLists.push_back(styleComponentsLists); // TODO: I think there is one useless list
-        StyleComponentDataList components = StyleComponentDataList();
-        std::list<StyleDefinition *> *finalStyleComponents =
-            createStyleComponents(requiredStyleComponentsLists.cbegin(), &components, appliedStyleMap);
+        addStyleDefinitions(styleComponentsLists, appliedStyleMap);
+    }
 
-        delete appliedStyleMap;
-        for (StyleComponentDataList *componentDataList : *(requiredStyleComponentsLists.back())) {
+    void NodesToStyleComponents::addStyleDefinitions(std::list<StyleComponentDataList *> *styleComponentsLists, StyleValuesMap *appliedStyleMap) {
+        // the rules are shared by all the definitions of the block, and the components are moved in their definition
+        std::shared_ptr<const StyleValuesMap> rules(appliedStyleMap);
+        int specificity;
+        for (StyleComponentDataList *componentDataList : *styleComponentsLists) {
+            specificity = computeRuleSpecifity(componentDataList);
+            styleDefinitions->push_back(new StyleDefinition(std::move(*componentDataList), rules, specificity));
             delete componentDataList;
         }
-        delete requiredStyleComponentsLists.back();
-        requiredStyleComponentsLists.pop_back();
-        if (finalStyleComponents != nullptr) {
-            styleDefinitions->splice(styleDefinitions->end(), *finalStyleComponents);
-            delete finalStyleComponents;
+        delete styleComponentsLists;
+    }
+
+    std::vector<NodesToStyleComponents::SelectorParts> NodesToStyleComponents::selectorsParts(const FlatTree &style, uint32_t blockSelectors) {
+        std::vector<SelectorParts> selectors;
+        for (uint32_t selector = style.firstChild(blockSelectors); selector != FlatTree::NO_NODE; selector = style.nextSibling(selector)) {
+            selectors.emplace_back();
+            for (uint32_t part = style.firstChild(selector); part != FlatTree::NO_NODE; part = style.nextSibling(part)) {
+                selectors.back().emplace_back(style.token(part), style.value(part));
+            }
+        }
+        return selectors;
+    }
+
+    void NodesToStyleComponents::joinSelector(SelectorParts *parentSelector, const SelectorParts &selector) {
+        SelectorParts::const_iterator selectorStart = selector.cbegin();
+        StyleRelation relation = selector.empty() ? StyleRelation::Null : tokenTypeToStyleRelation(selectorStart->first);
+        if (relation == StyleRelation::Null) parentSelector->emplace_back(Token::AnyParent, std::string_view());
+        // the & is the parent selector itself
+        else if (relation == StyleRelation::SameElement) selectorStart++;
+        parentSelector->insert(parentSelector->end(), selectorStart, selector.cend());
+    }
+
+    std::list<StyleComponentDataList *> *NodesToStyleComponents::expandSelectors(const SelectorsGroup &group) {
+        std::list<StyleComponentDataList *> *styleComponentsLists = new std::list<StyleComponentDataList *>();
+        // from the top level block to the block of the group
+        std::vector<const SelectorsGroup *> groups;
+        // index of the current selector of each group, the joined selector being built in parts
+        std::vector<size_t> indexes;
+        std::vector<size_t> sizes;
+        SelectorParts parts;
+        size_t level = 0;
+
+        for (const SelectorsGroup *parent = &group; parent != nullptr; parent = parent->parent) {
+            groups.insert(groups.begin(), parent);
+        }
+        indexes.assign(groups.size(), 0);
+        sizes.assign(groups.size(), 0);
+        while (true) {
+            if (indexes[level] == groups[level]->selectors.size()) {
+                if (level == 0) break;
+                level--;
+                parts.resize(sizes[level]);
+                indexes[level]++;
+                continue;
+            }
+            sizes[level] = parts.size();
+            const SelectorParts &selector = groups[level]->selectors[indexes[level]];
+            if (level == 0) parts.insert(parts.end(), selector.cbegin(), selector.cend());
+            else joinSelector(&parts, selector);
+            if (level + 1 < groups.size()) {
+                level++;
+                indexes[level] = 0;
+                continue;
+            }
+            styleComponentsLists->push_back(convertSelectorParts(parts));
+            parts.resize(sizes[level]);
+            indexes[level]++;
+        }
+        return styleComponentsLists;
+    }
+
+    StyleComponentDataList *NodesToStyleComponents::convertSelectorParts(const SelectorParts &parts) {
+        StyleComponentDataList *requiredStyleComponents = new StyleComponentDataList();
+        StyleComponentType styleComponentType;
+        StyleRelation styleRelationToken;
+        SelectorParts::const_iterator part = parts.cbegin();
+        SelectorParts::const_iterator currentPart;
+
+        // same as convertStyleComponents for each selector
+        while (part != parts.cend()) {
+            currentPart = part++;
+            styleComponentType = tokenTypeToStyleComponentType(currentPart->first);
+            if (styleComponentType == StyleComponentType::Null) continue;
+
+            if (part == parts.cend()) styleRelationToken = StyleRelation::SameElement;
+            else if (tokenTypeToStyleComponentType(part->first) != StyleComponentType::Null) styleRelationToken = StyleRelation::SameElement;
+            else {
+                styleRelationToken = tokenTypeToStyleRelation(part->first);
+                if (styleRelationToken != StyleRelation::Null) part++;
+            }
+            if (styleRelationToken != StyleRelation::Null) {
+                requiredStyleComponents->push_back(
+                    std::pair(StyleComponentData(std::string(currentPart->second), styleComponentType), styleRelationToken));
+            }
+        }
+        return requiredStyleComponents;
+    }
+
+    bool NodesToStyleComponents::ruleValid(const FlatTree &style, uint32_t rule) {
+        uint32_t ruleName = style.firstChild(rule);
+        uint32_t node = style.nextSibling(ruleName);
+        uint32_t ruleId = _config->ruleId(style.value(ruleName));
+        if (ruleId == config::CompiledConfig::NO_RULE) return false;
+        auto isValue = [&style](uint32_t node) {
+            return node != FlatTree::NO_NODE && tokenTypeToStyleValueType(style.token(node)) != StyleValueType::Null;
+        };
+        ruleMatch.start(&_config->ruleMatcher(ruleId));
+        // same traversal as for the nodes
+        while (node != FlatTree::NO_NODE) {
+            ruleMatch.open(style.token(node), style.value(node));
+            if (ruleMatch.failed()) return false;
+            if (isValue(style.firstChild(node))) {
+                node = style.firstChild(node);
+                continue;
+            }
+            for (; node != FlatTree::NO_NODE; node = (style.parent(node) == rule) ? FlatTree::NO_NODE : style.parent(node)) {
+                ruleMatch.close();
+                if (isValue(style.nextSibling(node))) {
+                    node = style.nextSibling(node);
+                    break;
+                }
+            }
+        }
+        return ruleMatch.matched();
+    }
+
+    StyleValue *NodesToStyleComponents::convertStyleNodeToStyleValue(const FlatTree &style, uint32_t node) {
+        // same traversal as for the nodes
+        std::vector<std::pair<uint32_t, StyleValue *>> pendingNodes;
+        std::pair<uint32_t, StyleValue *> pending;
+        auto convertNexts = [&style, &pendingNodes](uint32_t node, StyleValue *parent) {
+            StyleValue *first = nullptr;
+            StyleValue *last = nullptr;
+            StyleValueType type;
+            for (; node != FlatTree::NO_NODE && (type = tokenTypeToStyleValueType(style.token(node))) != StyleValueType::Null;
+                 node = style.nextSibling(node)) {
+                StyleValue *styleValue = new StyleValue(std::string(style.value(node)), type);
+                styleValue->number(style.number(node));
+                styleValue->parent(parent);
+                if (last == nullptr) first = styleValue;
+                else last->next(styleValue);
+                last = styleValue;
+                pendingNodes.emplace_back(node, styleValue);
+            }
+            return first;
+        };
+
+        StyleValue *styleValue = convertNexts(node, nullptr);
+        while (!pendingNodes.empty()) {
+            pending = pendingNodes.back();
+            pendingNodes.pop_back();
+            pending.second->addChild(convertNexts(style.firstChild(pending.first), pending.second));
+        }
+        return styleValue;
+    }
+
+    void NodesToStyleComponents::convertStyleBlock(const FlatTree &style, uint32_t block, const SelectorsGroup *parentSelectors, int fileNumber,
+                                                   int *ruleNumber) {
+        uint32_t blockSelectors = style.firstChild(block);
+        if (blockSelectors == FlatTree::NO_NODE) return;
+        uint32_t blockDeclarations = style.nextSibling(blockSelectors);
+        uint32_t ruleName;
+        uint32_t ruleValue;
+        StyleValue *styleValue;
+        std::list<StyleComponentDataList *> *styleComponentsLists;
+        StyleValuesMap *appliedStyleMap;
+        // the selectors of a nested block reference the ones of its parent, like when moving it to the root
+        SelectorsGroup selectors = {parentSelectors, selectorsParts(style, blockSelectors)};
+        bool hasSelectors = true;
+        for (const SelectorsGroup *group = &selectors; group != nullptr; group = group->parent) {
+            hasSelectors = hasSelectors && !group->selectors.empty();
+        }
+
+        if (style.token(blockSelectors) == Token::BlockSelectors && hasSelectors && blockDeclarations != FlatTree::NO_NODE) {
+            styleComponentsLists = expandSelectors(selectors);
+            appliedStyleMap = new StyleValuesMap();
+            for (uint32_t rule = style.firstChild(blockDeclarations); rule != FlatTree::NO_NODE; rule = style.nextSibling(rule)) {
+                if (style.token(rule) != Token::Assignment || !ruleValid(style, rule)) continue;
+                ruleName = style.firstChild(rule);
+                if (style.token(ruleName) != Token::RuleName) continue;
+                ruleValue = style.nextSibling(ruleName);
+                if (ruleValue == FlatTree::NO_NODE || style.token(ruleValue) == Token::NullRoot) continue;
+                styleValue = convertStyleNodeToStyleValue(style, ruleValue);
+                if (styleValue != nullptr) {
+                    appliedStyleMap->insert_or_assign(std::string(style.value(ruleName)),
+                                                      StyleRule(styleValue, true, fileNumber, *ruleNumber));
+                    delete styleValue;
+                    (*ruleNumber)++;
+                }
+            }
+            if (appliedStyleMap->empty()) {
+                for (StyleComponentDataList *componentDataList : *styleComponentsLists) {
+                    delete componentDataList;
+                }
+                delete styleComponentsLists;
+                delete appliedStyleMap;
+            }
+            else addStyleDefinitions(styleComponentsLists, appliedStyleMap);
+        }
+
+        if (blockDeclarations == FlatTree::NO_NODE) return;
+        for (uint32_t content = style.firstChild(blockDeclarations); content != FlatTree::NO_NODE; content = style.nextSibling(content)) {
+            if (style.token(content) == Token::StyleBlock) convertStyleBlock(style, content, &selectors, fileNumber, ruleNumber);
+        }
+    }
+
+    void NodesToStyleComponents::reset() {
+        tree = nullptr;
+        styleDefinitions = nullptr;
+        selectorsGroups.clear();
+        blocksSelectors.clear();
+        nodes.reset();
+        parser.reset();
+    }
+
+    void NodesToStyleComponents::convertFlatStyle(const FlatTree &style, int fileNumber, int *ruleNumber) {
+        if (style.empty()) return;
+        for (uint32_t block = style.firstChild(0); block != FlatTree::NO_NODE; block = style.nextSibling(block)) {
+            if (style.token(block) == Token::StyleBlock) convertStyleBlock(style, block, nullptr, fileNumber, ruleNumber);
+            else if (style.token(block) == Token::Import) {
+                // like Parser::parseFlat, the imported style is parsed in a tree of nodes copied in a flat tree
+                convertFlatStyle(FlatTree::fromNodes(deserializeStyleFromFile(std::string(style.value(block)))), fileNumber, ruleNumber);
+            }
         }
     }
 
     std::list<StyleDefinition *> *NodesToStyleComponents::convert(const std::string &style, int fileNumber, int *ruleNumber) {
         *ruleNumber = 0;
+        reset();
+        NodeArena::Scope nodesScope(&nodes);
+        return convertStyleTree(deserializeStyle(style), fileNumber, ruleNumber);
+    }
 
-        DeserializationNode *styleTree = deserializeStyle(style);
+    std::list<StyleDefinition *> *NodesToStyleComponents::convert(std::istream &style, int fileNumber, int *ruleNumber) {
+        *ruleNumber = 0;
+        reset();
+        NodeArena::Scope nodesScope(&nodes);
+        return convertStyleTree(deserializeStyle(style), fileNumber, ruleNumber);
+    }
+
+    std::list<StyleDefinition *> *NodesToStyleComponents::convert(const FlatTree &style, int fileNumber, int *ruleNumber) {
+        *ruleNumber = 0;
+        reset();
+        // the imported styles are deserialized in the arena
+        NodeArena::Scope nodesScope(&nodes);
+        styleDefinitions = new std::list<StyleDefinition *>();
+        try {
+            convertFlatStyle(style, fileNumber, ruleNumber);
+        }
+        catch (const std::exception &) {
+            for (StyleDefinition *styleDefinition : *styleDefinitions) {
+                delete styleDefinition;
+            }
+            delete styleDefinitions;
+            reset();
+            throw;
+        }
+        nodes.reset();
+        return styleDefinitions;
+    }
+
+    std::list<StyleDefinition *> *NodesToStyleComponents::convertInParallel(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                            unsigned int threadsCount) {
+        *ruleNumber = 0;
+        reset();
+        NodeArena::Scope nodesScope(&nodes);
+        return convertStyleTree(deserializeStyleInParallel(style, threadsCount), fileNumber, ruleNumber);
+    }
 
+    std::list<StyleDefinition *> *NodesToStyleComponents::convertStyleTree(DeserializationNode *styleTree, int fileNumber, int *ruleNumber) {
         flattenStyle(styleTree);
 #ifdef DEBUG
         std::clog << "flattened style\n";
@@ -468,9 +714,11 @@ namespace style {
             tree = tree->next();
         }
 
-        requiredStyleComponentsLists.clear();
+        selectorsGroups.clear();
+        blocksSelectors.clear();
 
-        delete styleTree;
+        // the tree is in the arena, so it is released without deleting its nodes
+        nodes.reset();
 
         return styleDefinitions;
     }
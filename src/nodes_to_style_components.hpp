@@ -2,30 +2,69 @@
 #define NODES_TO_STYLE_COMPONENT_HPP
 
 #include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
 #include "deserialization_node.hpp"
+#include "flat_tree.hpp"
+#include "lexer.hpp"
+#include "node_arena.hpp"
+#include "parser.hpp"
 #include "style_component.hpp"
+#include "token_stream.hpp"
 
+#include <istream>
 #include <list>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace style {
 
     class NodesToStyleComponents {
-        const config::Config *_config = nullptr;
+        // the compiler shares the conversion of the selectors and the creation of the definitions
+        friend class StyleCompiler;
+
+        // tokens and values of the components of a selector, with their relations
+        using SelectorParts = std::vector<std::pair<Token, std::string_view>>;
+        /**
+         * Selectors of a block, referencing the ones of the block containing it instead of being joined to copies of them.
+         * They are joined like joinSelector does only when the definitions of the block are created (see expandSelectors).
+         */
+        struct SelectorsGroup {
+            // selectors of the block containing this one, nullptr for a top level block
+            const SelectorsGroup *parent;
+            std::vector<SelectorParts> selectors;
+        };
+
+        const config::CompiledConfig *_config = nullptr;
+        // compiled from the config the converter was given, nullptr when it was given a compiled config
+        config::CompiledConfig *_ownedConfig = nullptr;
         DeserializationNode *tree = nullptr;
-        // for each inner style block, multiple components list definitions (separated by commas in the style files)
-        std::list<std::list<StyleComponentDataList *> *> requiredStyleComponentsLists = std::list<std::list<StyleComponentDataList *> *>();
         std::list<StyleDefinition *> *styleDefinitions = nullptr;
-
-        DeserializationNode *deserializeStyle(const std::string &style);
+        // all the nodes created during a conversion, released at once at its end, its blocks being kept for the next conversion
+        NodeArena nodes;
+        // selectors of the blocks moved to the root and of the blocks containing them, referencing the values of the nodes in the arena
+        std::list<SelectorsGroup> selectorsGroups = std::list<SelectorsGroup>();
+        std::unordered_map<const DeserializationNode *, const SelectorsGroup *> blocksSelectors =
+            std::unordered_map<const DeserializationNode *, const SelectorsGroup *>();
+        // kept from a conversion to the next one with their buffers
+        Parser parser;
+        config::RuleMatcher::Match ruleMatch;
+        std::vector<const DeserializationNode *> ruleValueParents;
+
+        DeserializationNode *deserializeStyle(std::string_view style);
+        DeserializationNode *deserializeStyle(std::istream &style);
+        DeserializationNode *deserializeStyleInParallel(std::string_view style, unsigned int threadsCount);
 
         DeserializationNode *deserializeStyleFromFile(const std::string &fileName);
 
-        static DeserializationNode *joinStyleDeclarations(DeserializationNode *firstDeclarations, DeserializationNode *secondDeclarations);
-        static void moveNestedBlocksToRoot(DeserializationNode *style);
+        static std::vector<SelectorParts> selectorsParts(const DeserializationNode *blockSelectors);
+        const SelectorsGroup *selectorsGroup(const DeserializationNode *block);
+        void moveNestedBlocksToRoot(DeserializationNode *style);
         void flattenStyle(DeserializationNode *style);
 
-        bool ruleNodesValid(const DeserializationNode *ruleNode, const config::ConfigRuleNode *configNode);
+        // the whole value of the rule is matched with its matcher in the config
         bool ruleValid(const DeserializationNode *rule);
         void filterRulesWithConfiguration(DeserializationNode *style);
 
@@ -35,19 +74,63 @@ namespace style {
 
         StyleValuesMap *convertAppliedStyle(int fileNumber, int *ruleNumber);
 
-        /**
-         * Does not accept a null pointer for "components" parameter
-         */
-        std::list<StyleDefinition *> *createStyleComponents(std::list<std::list<StyleComponentDataList *> *>::const_iterator componentsListIt,
-                                                            StyleComponentDataList *components, StyleValuesMap *appliedStyle);
-
         int computeRuleSpecifity(StyleComponentDataList *ruleComponents);
 
+        // create the definitions of a block from its selectors and rules, sharing the rules and deleting the selectors
+        void addStyleDefinitions(std::list<StyleComponentDataList *> *styleComponentsLists, StyleValuesMap *appliedStyleMap);
+
         void convertStyleDefinition(int fileNumber, int *ruleNumber);
 
+        // conversion of a FlatTree, giving the same definitions as flattening, filtering and converting the nodes
+        static std::vector<SelectorParts> selectorsParts(const FlatTree &style, uint32_t blockSelectors);
+        /**
+         * Append a selector of a nested block to one of its parent block, adding AnyParent if it doesn't start with a relation
+         * and skipping its leading &
+         */
+        static void joinSelector(SelectorParts *parentSelector, const SelectorParts &selector);
+        /**
+         * Components lists of all the joined selectors of a group, for each selector of the top level block the ones of its nested blocks
+         */
+        static std::list<StyleComponentDataList *> *expandSelectors(const SelectorsGroup &group);
+        static StyleComponentDataList *convertSelectorParts(const SelectorParts &parts);
+        bool ruleValid(const FlatTree &style, uint32_t rule);
+        StyleValue *convertStyleNodeToStyleValue(const FlatTree &style, uint32_t node);
+        void convertStyleBlock(const FlatTree &style, uint32_t block, const SelectorsGroup *parentSelectors, int fileNumber, int *ruleNumber);
+        void convertFlatStyle(const FlatTree &style, int fileNumber, int *ruleNumber);
+
+        std::list<StyleDefinition *> *convertStyleTree(DeserializationNode *styleTree, int fileNumber, int *ruleNumber);
+
     public:
-        NodesToStyleComponents(const config::Config *config) : _config{config} {}
+        /**
+         * Throws InvalidStyleConfigException if the config is invalid, the config being validated and compiled once for all the conversions
+         */
+        NodesToStyleComponents(const config::Config *config);
+        /**
+         * The compiled config must outlive the converter
+         */
+        NodesToStyleComponents(const config::CompiledConfig *config) : _config{config} {}
+        NodesToStyleComponents(const NodesToStyleComponents &) = delete;
+        NodesToStyleComponents &operator=(const NodesToStyleComponents &) = delete;
+        ~NodesToStyleComponents();
+        /**
+         * Forget the conversion in progress, so the converter can be used again after an exception.
+         * Each conversion starts with a reset, and the arena of the nodes, the parser and the lexer keep their memory,
+         * so converting many small styles with the same converter only allocates the returned definitions.
+         */
+        void reset();
         std::list<StyleDefinition *> *convert(const std::string &style, int fileNumber, int *ruleNumber);
+        /**
+         * The style is lexed by chunks, without reading it entirely in memory
+         */
+        std::list<StyleDefinition *> *convert(std::istream &style, int fileNumber, int *ruleNumber);
+        /**
+         * The nested blocks are converted while traversing the tree, without moving nor copying its nodes
+         */
+        std::list<StyleDefinition *> *convert(const FlatTree &style, int fileNumber, int *ruleNumber);
+        /**
+         * The style is lexed and parsed on threadsCount threads (see ParallelParser), the rules being numbered like with convert
+         */
+        std::list<StyleDefinition *> *convertInParallel(const std::string &style, int fileNumber, int *ruleNumber, unsigned int threadsCount = 0);
     };
 
 } // namespace style
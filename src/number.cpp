@@ -0,0 +1,65 @@
+#include "number.hpp"
+
+#include <charconv>
+#include <limits>
+
+namespace style {
+
+    std::string numberDiagnosticToString(NumberDiagnostic diagnostic) {
+        switch (diagnostic) {
+        case NumberDiagnostic::None:
+            return "None";
+        case NumberDiagnostic::Overflow:
+            return "Overflow";
+        case NumberDiagnostic::PrecisionLoss:
+            return "PrecisionLoss";
+        default:
+            return "Unknown";
+        }
+    }
+
+    Number decodeInt(std::string_view value) {
+        Number number;
+        std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), number.intValue);
+        if (result.ec == std::errc::result_out_of_range) {
+            number.intValue = (!value.empty() && value[0] == '-') ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+            number.diagnostic = NumberDiagnostic::Overflow;
+        }
+        return number;
+    }
+
+    Number decodeFloat(std::string_view value) {
+        Number number;
+        number.floatValue = 0;
+        std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), number.floatValue);
+        if (result.ec == std::errc::result_out_of_range) {
+            number.diagnostic = NumberDiagnostic::Overflow;
+            return number;
+        }
+        // significant digits, from the first to the last non zero digit
+        size_t first = value.find_first_of("123456789");
+        if (first == std::string_view::npos) return number;
+        size_t last = value.find_last_of("123456789");
+        size_t digits = last - first + 1;
+        if (value.find('.', first) < last) digits--;
+        if (digits > std::numeric_limits<double>::digits10) number.diagnostic = NumberDiagnostic::PrecisionLoss;
+        return number;
+    }
+
+    bool decodeHexColor(std::string_view value, uint32_t *rgba) {
+        if (value.size() != 3 && value.size() != 6 && value.size() != 8) return false;
+        uint32_t digits;
+        std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), digits, 16);
+        if (result.ec != std::errc() || result.ptr != value.data() + value.size()) return false;
+        if (value.size() == 3) {
+            uint32_t red = (digits >> 8) & 0xf;
+            uint32_t green = (digits >> 4) & 0xf;
+            uint32_t blue = digits & 0xf;
+            *rgba = (red * 0x11) << 24 | (green * 0x11) << 16 | (blue * 0x11) << 8 | 0xff;
+        }
+        else if (value.size() == 6) *rgba = digits << 8 | 0xff;
+        else *rgba = digits;
+        return true;
+    }
+
+} // namespace style
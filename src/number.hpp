@@ -0,0 +1,42 @@
+#ifndef NUMBER_HPP
+#define NUMBER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace style {
+
+    enum class NumberDiagnostic : uint8_t {
+        None,
+        Overflow,      // the int doesn't fit in 64 bits, the value is clamped
+        PrecisionLoss, // the float has more significant digits than a double can keep
+    };
+
+    std::string numberDiagnosticToString(NumberDiagnostic diagnostic);
+
+    /**
+     * Binary value of an Int (intValue) or Float (floatValue) token, decoded once by the lexer,
+     * or of a Hex node (rgbaValue), decoded by the parser
+     */
+    struct Number {
+        union {
+            int64_t intValue = 0;
+            double floatValue;
+            // 0xRRGGBBAA
+            uint32_t rgbaValue;
+        };
+        NumberDiagnostic diagnostic = NumberDiagnostic::None;
+    };
+
+    Number decodeInt(std::string_view value);
+    Number decodeFloat(std::string_view value);
+    /**
+     * Decode "rgb", "rrggbb" or "rrggbbaa" (without the '#') in rgba, the alpha being ff if not given.
+     * Return false if the value is not one of them.
+     */
+    bool decodeHexColor(std::string_view value, uint32_t *rgba);
+
+} // namespace style
+
+#endif // NUMBER_HPP
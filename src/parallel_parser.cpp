@@ -0,0 +1,132 @@
+#include "parallel_parser.hpp"
+#include "character_scanner.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace style {
+
+    ParallelParser::ParallelParser(unsigned int threadsCount, size_t minChunkSize)
+        : _threadsCount{threadsCount ? threadsCount : std::max(1u, std::thread::hardware_concurrency())}, _minChunkSize{minChunkSize} {}
+
+    std::vector<size_t> ParallelParser::splitPoints(std::string_view expression, const config::Config *config, size_t minChunkSize) {
+        std::vector<size_t> points;
+        size_t i = 0;
+        size_t end;
+        size_t depth = 0;
+        size_t chunkStart = 0;
+
+        for (const std::string &unit : config->units) {
+            if (unit.find_first_of("{}\"'/\n") != std::string::npos) i = expression.size();
+        }
+        while (i < expression.size()) {
+            switch (expression[i]) {
+            case '"':
+            case '\'':
+                // like the lexer, the closing quote is searched from the second character after the opening one
+                end = scanner::findCharacter(expression, i + 2, expression[i]);
+                // an unclosed string can't be lexed, nothing after it is split
+                i = (end == expression.size()) ? end : end + 1;
+                break;
+            case '/':
+                if (i + 1 < expression.size() && expression[i + 1] == '/') i = scanner::findCharacter(expression, i + 2, '\n');
+                else if (i + 1 < expression.size() && expression[i + 1] == '*') {
+                    end = scanner::findMultiLineCommentEnd(expression, i + 2);
+                    i = (end == expression.size()) ? end : end + 2;
+                }
+                else i++;
+                break;
+            case '{':
+                depth++;
+                i++;
+                break;
+            case '}':
+                // an unopened block can't be parsed, nothing after it is split
+                if (depth == 0) {
+                    i = expression.size();
+                    break;
+                }
+                depth--;
+                i++;
+                // the line break keeps the next block from being joined to this one, like in "a {} .b {}"
+                if (depth == 0 && i < expression.size() && expression[i] == '\n' && i - chunkStart >= minChunkSize) {
+                    points.push_back(i);
+                    chunkStart = i;
+                }
+                break;
+            default:
+                i++;
+                break;
+            }
+        }
+        points.push_back(expression.size());
+        return points;
+    }
+
+    std::vector<DeserializationNode *> ParallelParser::parseChunks(std::string_view expression, const std::vector<size_t> &splitPoints,
+                                                                   const config::CompiledConfig *config) const {
+        std::vector<DeserializationNode *> trees(splitPoints.size(), nullptr);
+        std::vector<std::exception_ptr> errors(splitPoints.size(), nullptr);
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<bool> failed{false};
+        NodeArena *arena = NodeArena::current();
+        // the chunks are taken in the source order, so the ones before a failed chunk are all parsed
+        auto parseNextChunks = [&]() {
+            size_t chunk;
+            size_t start;
+            Parser parser;
+            // the arena of the calling thread can't be shared
+            NodeArena::Scope arenaScope(arena ? arena->newChild() : nullptr);
+            while (!failed && (chunk = nextChunk++) < splitPoints.size()) {
+                start = chunk ? splitPoints[chunk - 1] : 0;
+                try {
+                    trees[chunk] = parser.parse(expression.substr(start, splitPoints[chunk] - start), config);
+                }
+                catch (const std::exception &) {
+                    errors[chunk] = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < _threadsCount && i < splitPoints.size(); i++) {
+            threads.emplace_back(parseNextChunks);
+        }
+        parseNextChunks();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        if (failed) {
+            for (DeserializationNode *tree : trees) {
+                delete tree;
+            }
+            std::rethrow_exception(*std::find_if(errors.cbegin(), errors.cend(), [](const std::exception_ptr &error) { return error != nullptr; }));
+        }
+        return trees;
+    }
+
+    DeserializationNode *ParallelParser::parse(std::string_view expression, const config::Config *config) const {
+        config::CompiledConfig compiledConfig = config::CompiledConfig(config);
+        return parse(expression, &compiledConfig);
+    }
+
+    DeserializationNode *ParallelParser::parse(std::string_view expression, const config::CompiledConfig *config) const {
+        std::vector<size_t> points = splitPoints(expression, config->config(), _minChunkSize);
+        if (_threadsCount == 1 || points.size() == 1) return Parser().parse(expression, config);
+
+        std::vector<DeserializationNode *> trees = parseChunks(expression, points, config);
+        DeserializationNode *root = trees[0];
+        DeserializationNode *first;
+        for (size_t i = 1; i < trees.size(); i++) {
+            first = trees[i]->child();
+            trees[i]->removeChilds();
+            delete trees[i];
+            root->addChild(first);
+        }
+        return root;
+    }
+
+} // namespace style
@@ -0,0 +1,53 @@
+#ifndef PARALLEL_PARSER_HPP
+#define PARALLEL_PARSER_HPP
+
+#include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
+#include "deserialization_node.hpp"
+#include <string_view>
+#include <vector>
+
+constexpr size_t DEFAULT_PARALLEL_CHUNK_SIZE = 16 * 1024;
+
+namespace style {
+
+    /**
+     * Lexe and parse a large style in parallel.
+     * The style is split after the top level closing curly brackets followed by a line break (outside of strings and comments),
+     * each chunk is parsed on its own thread and the blocks of the chunks are joined in the source order,
+     * giving the same tree as Parser::parse.
+     * If chunks can't be parsed, the exception of the first of them in the source order is raised, which is the one Parser::parse raises
+     * since the blocks before it are parsed the same way.
+     */
+    class ParallelParser {
+        unsigned int _threadsCount;
+        size_t _minChunkSize;
+
+        // parse each chunk with a parser per thread, raising the exception of the first chunk who failed
+        std::vector<DeserializationNode *> parseChunks(std::string_view expression, const std::vector<size_t> &splitPoints,
+                                                       const config::CompiledConfig *config) const;
+
+    public:
+        /**
+         * A threadsCount of 0 uses as many threads as the processor can run at the same time.
+         * The chunks are at least minChunkSize characters long, smaller styles are parsed serially.
+         */
+        ParallelParser(unsigned int threadsCount = 0, size_t minChunkSize = DEFAULT_PARALLEL_CHUNK_SIZE);
+        /**
+         * Positions where the expression can be split, the end of the expression being the last one.
+         * Only the end is returned if a unit of the config could hide a curly bracket, a quote or a comment.
+         */
+        static std::vector<size_t> splitPoints(std::string_view expression, const config::Config *config, size_t minChunkSize);
+        /**
+         * The nodes of the returned tree reference the expression, so it must outlive the tree.
+         */
+        DeserializationNode *parse(std::string_view expression, const config::Config *config) const;
+        /**
+         * Same as parse, the chunks sharing the units compiled once in the config
+         */
+        DeserializationNode *parse(std::string_view expression, const config::CompiledConfig *config) const;
+    };
+
+} // namespace style
+
+#endif // PARALLEL_PARSER_HPP
@@ -2,7 +2,15 @@
 
 namespace style {
 
-    bool Parser::isValidName(const std::string &str, size_t start, size_t end) {
+    namespace {
+        // current tokens of the parser when it is on white spaces
+        const LexedToken SPACE_TOKEN = LexedToken{Token::Space, 0, 0, 0, Number{}};
+        const LexedToken LINE_BREAK_TOKEN = LexedToken{Token::LineBreak, 0, 0, 0, Number{}};
+
+        const LexedToken *whiteSpacesToken(uint8_t whiteSpaces) { return (whiteSpaces & PRECEDED_BY_LINE_BREAK) ? &LINE_BREAK_TOKEN : &SPACE_TOKEN; }
+    } // namespace
+
+    bool Parser::isValidName(std::string_view str, size_t start, size_t end) {
         size_t i;
         for (i = start; i < end - 1; i++) {
             if (!isalpha(str[i]) && str[i] != '_' && str[i] != '-') return false;
@@ -11,33 +19,220 @@ namespace style {
         return true;
     }
 
-    bool Parser::isValidElementOrRuleName(const std::string &str) {
-        if (!isalpha(str[0])) return false;
+    bool Parser::isValidElementOrRuleName(std::string_view str) {
+        if (str.empty() || !isalpha(str[0])) return false;
         return str.size() == 1 || isValidName(str, 1, str.size());
     }
 
-    DeserializationNode *Parser::parse(DeserializationNode *currentNode) {
-        _currentNode = currentNode;
+    void Parser::reset() {
+        _tokens = nullptr;
+        _lexer = nullptr;
+        _pullLexer.reset();
+        _pulledTokens.reset("");
+        _currentIndex = 0;
+        _onWhiteSpaces = false;
+        _currentToken = nullptr;
+        _trailingWhiteSpaces = 0;
+        _whiteSpacesParent = nullptr;
+        _expressionTreeRoot = nullptr;
+        _parsedTree = nullptr;
+        _flatNodes.reset();
+    }
+
+    DeserializationNode *Parser::parse(const TokenStream &tokens) {
+        _tokens = &tokens;
+        _copyValues = false;
+        return parseTokens();
+    }
+
+    DeserializationNode *Parser::parse(const DeserializationNode *currentNode) {
+        std::string buffer;
+        TokenStream tokens = TokenStream::fromNodes(currentNode, &buffer);
+        _tokens = &tokens;
+        _copyValues = true;
+        DeserializationNode *result = parseTokens();
+        _tokens = nullptr;
+        return result;
+    }
+
+    DeserializationNode *Parser::parseExpression(std::string_view expression) {
+        _pulledTokens.reset(expression);
+        _copyValues = false;
+        return parsePulledTokens();
+    }
+
+    DeserializationNode *Parser::parse(std::string_view expression, const config::Config *config) {
+        _pullLexer.start(expression, config);
+        return parseExpression(expression);
+    }
+
+    DeserializationNode *Parser::parse(std::string_view expression, const config::CompiledConfig *config) {
+        _pullLexer.start(expression, config);
+        return parseExpression(expression);
+    }
+
+    DeserializationNode *Parser::parse(const ReadCallback &read, const config::CompiledConfig *config, size_t chunkSize) {
+        _pullLexer.startStream(read, config, chunkSize);
+        // the values of the tokens are dropped with them, so the nodes own copies
+        _pulledTokens.resetOwningValues();
+        _copyValues = true;
+        return parsePulledTokens();
+    }
+
+    DeserializationNode *Parser::parse(std::istream &input, const config::CompiledConfig *config, size_t chunkSize) {
+        return parse(
+            [&input](char *buffer, size_t size) {
+                input.read(buffer, size);
+                return static_cast<size_t>(input.gcount());
+            },
+            config, chunkSize);
+    }
+
+    DeserializationNode *Parser::parsePulledTokens() {
+        _lexer = &_pullLexer;
+        _tokens = &_pulledTokens;
+        DeserializationNode *result;
+        try {
+            result = parseTokens();
+        }
+        catch (const ParserException &) {
+            // as when the whole expression is lexed before being parsed, an error of the lexer later in the expression has the precedence
+            try {
+                LexedToken token;
+                while (_lexer != nullptr && _lexer->nextToken(&token)) {}
+            }
+            catch (...) {
+                reset();
+                throw;
+            }
+            reset();
+            throw;
+        }
+        catch (...) {
+            reset();
+            throw;
+        }
+        _lexer = nullptr;
+        _tokens = nullptr;
+        _pullLexer.reset();
+        _pulledTokens.reset("");
+        return result;
+    }
+
+    FlatTree Parser::parseFlat(std::string_view expression, const config::Config *config) {
+        NodeArena::Scope nodesScope(&_flatNodes);
+        FlatTree flatTree;
+        try {
+            flatTree = FlatTree::fromNodes(parse(expression, config));
+        }
+        catch (...) {
+            _flatNodes.reset();
+            throw;
+        }
+        _flatNodes.reset();
+        return flatTree;
+    }
+
+    bool Parser::hasToken(size_t index) {
+        if (index < _tokens->size()) return true;
+        if (_lexer == nullptr) return false;
+        LexedToken token;
+        while (index >= _pulledTokens.size()) {
+            if (!_lexer->nextToken(&token)) {
+                _lexer = nullptr;
+                break;
+            }
+            if (_lexer->streams()) _pulledTokens.pushValue(token, _lexer->value(token));
+            else _pulledTokens.push(token);
+        }
+        // the pulled tokens can have been reallocated
+        if (!_onWhiteSpaces && _currentIndex < _pulledTokens.size()) _currentToken = &_pulledTokens[_currentIndex];
+        return index < _pulledTokens.size();
+    }
+
+    size_t Parser::skipWhiteSpaces(size_t index, uint8_t *whiteSpaces) {
+        while (hasToken(index)) {
+            const LexedToken &token = (*_tokens)[index];
+            *whiteSpaces |= token.flags;
+            switch (token.token) {
+            case Token::Space:
+                *whiteSpaces |= PRECEDED_BY_SPACE;
+                break;
+            case Token::LineBreak:
+                *whiteSpaces |= PRECEDED_BY_LINE_BREAK;
+                break;
+            case Token::OneLineComment:
+            case Token::MultiLineComment:
+                break;
+            default:
+                return index;
+            }
+            index++;
+        }
+        return index;
+    }
+
+    void Parser::moveTo(size_t index, uint8_t whiteSpaces) {
+        _currentIndex = index;
+        _onWhiteSpaces = whiteSpaces != 0;
+        if (_onWhiteSpaces) _currentToken = whiteSpacesToken(whiteSpaces);
+        else _currentToken = hasToken(index) ? &(*_tokens)[index] : nullptr;
+    }
+
+    const LexedToken *Parser::nextToken() {
+        if (_currentToken == nullptr) return nullptr;
+        if (_onWhiteSpaces) return hasToken(_currentIndex) ? &(*_tokens)[_currentIndex] : nullptr;
+        uint8_t whiteSpaces = 0;
+        size_t index = skipWhiteSpaces(_currentIndex + 1, &whiteSpaces);
+        if (whiteSpaces) return whiteSpacesToken(whiteSpaces);
+        return hasToken(index) ? &(*_tokens)[index] : nullptr;
+    }
+
+    bool Parser::advance() {
+        if (_currentToken == nullptr) return false;
+        if (_tokens == &_pulledTokens && _currentIndex > 0) {
+            // the tokens before the current one are parsed
+            _pulledTokens.discard(_currentIndex);
+            _currentIndex = 0;
+            if (!_onWhiteSpaces) _currentToken = &_pulledTokens[0];
+        }
+        uint8_t whiteSpaces = 0;
+        if (_onWhiteSpaces) moveTo(_currentIndex, 0);
+        else {
+            size_t index = skipWhiteSpaces(_currentIndex + 1, &whiteSpaces);
+            moveTo(index, whiteSpaces);
+        }
+        return _currentToken != nullptr;
+    }
+
+    DeserializationNode *Parser::newNode(Token token) const {
+        DeserializationNode *node = new DeserializationNode(token);
+        if (_copyValues) node->value(currentValue());
+        else node->borrowValue(currentValue());
+        node->number(_currentToken->number);
+        return node;
+    }
+
+    DeserializationNode *Parser::parseTokens() {
+        uint8_t whiteSpaces = 0;
+        size_t index = skipWhiteSpaces(0, &whiteSpaces);
+        moveTo(index, whiteSpaces);
+        _trailingWhiteSpaces = 0;
+        _whiteSpacesParent = nullptr;
         _expressionTreeRoot = new DeserializationNode(Token::NullRoot);
         _parsedTree = _expressionTreeRoot;
         try {
-            while (_currentNode != nullptr) {
+            while (_currentToken != nullptr) {
 #ifdef DEBUG_DEBUG
-                std::clog << "\nActual token : " << tokenToString(_currentNode->token()) << ": '" << _currentNode->value() << "'" << "\n";
+                std::clog << "\nActual token : " << tokenToString(_currentToken->token) << ": '" << currentValue() << "'" << "\n";
 #endif
-                switch (_currentNode->token()) {
+                switch (_currentToken->token) {
                 case Token::Space:
                     parseSpace();
                     break;
                 case Token::LineBreak:
                     parseLineBreak();
                     break;
-                case Token::OneLineComment:
-                    parseOneLineComment();
-                    break;
-                case Token::MultiLineComment:
-                    parseMultiLineComment();
-                    break;
                 case Token::String:
                     parseString();
                     break;
@@ -92,14 +287,14 @@ namespace style {
                     parseClosingCurlyBracket();
                     break;
                 default:
-                    throw UnknownTokenException(*_currentNode);
+                    throw UnknownTokenException(_currentToken->token, currentValue());
                 }
 #ifdef DEBUG_DEBUG
                 std::clog << "Root :\n";
                 _expressionTreeRoot->debugDisplay(std::clog);
                 std::clog << "\n";
 #endif
-                _currentNode = _currentNode->next();
+                advance();
             }
             removeWhiteSpaces();
 #ifdef DEBUG
@@ -109,7 +304,8 @@ namespace style {
 #endif
             if (_parsedTree != _expressionTreeRoot) throw MalformedExpressionException("Block not properly closed\n");
         }
-        catch (const ParserException &) {
+        // in pull mode, lexer exceptions are also thrown while parsing
+        catch (const std::exception &) {
             _parsedTree = nullptr;
             delete _expressionTreeRoot;
             _expressionTreeRoot = nullptr;
@@ -118,26 +314,27 @@ namespace style {
         return _expressionTreeRoot;
     }
 
-    bool Parser::isWhiteSpace(Token token) { return (token == Token::Space || token == Token::LineBreak); }
-
     bool Parser::isComponentRelation(Token token) { return (token == Token::AnyParent || token == Token::DirectParent); }
 
+    void Parser::addTrailingWhiteSpaces(uint8_t whiteSpaces) {
+        if (_whiteSpacesParent != _parsedTree) {
+            _whiteSpacesParent = _parsedTree;
+            _trailingWhiteSpaces = 0;
+        }
+        _trailingWhiteSpaces |= whiteSpaces;
+    }
+
     void Parser::removeSpace() {
-        DeserializationNode *lastChild = _parsedTree->getLastChild();
-        if (lastChild != nullptr && lastChild->token() == Token::Space) _parsedTree->deleteSpecificChild(lastChild);
+        if (trailingWhiteSpaces()) _trailingWhiteSpaces &= ~PRECEDED_BY_SPACE;
     }
 
     void Parser::removeLineReturn() {
-        DeserializationNode *lastChild = _parsedTree->getLastChild();
-        if (lastChild != nullptr && lastChild->token() == Token::LineBreak) _parsedTree->deleteSpecificChild(lastChild);
+        if (trailingWhiteSpaces()) _trailingWhiteSpaces &= ~PRECEDED_BY_LINE_BREAK;
     }
 
     void Parser::removeWhiteSpaces() {
-        DeserializationNode *lastChild = _parsedTree->getLastChild();
-        while (lastChild != nullptr && (lastChild->token() == Token::Space || lastChild->token() == Token::LineBreak)) {
-            _parsedTree->deleteSpecificChild(lastChild);
-            lastChild = _parsedTree->getLastChild();
-        }
+        _trailingWhiteSpaces = 0;
+        _whiteSpacesParent = nullptr;
     }
 
     void Parser::parseSpace() {
@@ -149,7 +346,7 @@ namespace style {
                     _parsedTree->addChild(new DeserializationNode(Token::AnyParent));
             }
         }
-        else _parsedTree->addChild(_currentNode->copyNode());
+        else addTrailingWhiteSpaces(PRECEDED_BY_SPACE);
     }
 
     void Parser::parseLineBreak() {
@@ -157,13 +354,9 @@ namespace style {
         if (token != Token::NullRoot && token != Token::BlockDeclarations) {
             throw MalformedExpressionException("A line break can only be between blocks declarations or assignments");
         }
-        _parsedTree->addChild(_currentNode->copyNode());
+        addTrailingWhiteSpaces(PRECEDED_BY_LINE_BREAK);
     }
 
-    void Parser::parseOneLineComment() {}
-
-    void Parser::parseMultiLineComment() {}
-
     void Parser::parseValue() {
         removeSpace();
 
@@ -176,11 +369,11 @@ namespace style {
             if (lastChild != nullptr && lastChild->token() != Token::ArgSeparator)
                 throw MalformedExpressionException("The elements in a tuple or the parameters of a function must be comma separated");
             _parsedTree->deleteSpecificChild(lastChild);
-            _parsedTree->addChild(_currentNode->copyNode());
+            _parsedTree->addChild(newNode(_currentToken->token));
         }
         else {
             if (_parsedTree->nbChilds() > 1) throw MalformedExpressionException("Can only have one rvalue in an assignment");
-            _parsedTree->addChild(_currentNode->copyNode());
+            _parsedTree->addChild(newNode(_currentToken->token));
         }
     }
 
@@ -201,17 +394,18 @@ namespace style {
     void Parser::parseColon() {
         removeSpace();
 
-        DeserializationNode *lastChild = _parsedTree->getLastChild();
+        // a remaining line break is the last child
+        DeserializationNode *lastChild = trailingWhiteSpaces() ? nullptr : _parsedTree->getLastChild();
         DeserializationNode *newChild;
         if (_parsedTree->token() == Token::BlockDeclarations && lastChild != nullptr && lastChild->token() == Token::Name) {
             lastChild->token(Token::RuleName);
+            // the last child is moved in the assignment, which takes its place
             newChild = new DeserializationNode(Token::Assignment);
-            newChild->addChild(lastChild->copyNodeWithChilds());
-            _parsedTree->replaceChild(lastChild, newChild);
-            _parsedTree = newChild;
+            newChild->addChild(_parsedTree->detachChild(lastChild));
+            _parsedTree = _parsedTree->addChild(newChild);
         }
-        else if (_currentNode->next()->token() == Token::RawName) {
-            _currentNode = _currentNode->next();
+        else if (nextToken() != nullptr && nextToken()->token == Token::RawName) {
+            advance();
             parseModifier();
         }
         else throw MalformedExpressionException("A colon must be inside of a style block");
@@ -227,7 +421,7 @@ namespace style {
     void Parser::parseSharp() {
         DeserializationNode *lastChild;
         removeSpace();
-        _currentNode = _currentNode->next();
+        if (!advance()) throw MalformedExpressionException("A '#' must be followed by an identifier or an hexadecimal value");
         if (_parsedTree->token() != Token::Assignment) {
             if (_parsedTree->token() != Token::Tuple && _parsedTree->token() != Token::Function) {
                 parseIdentifier();
@@ -238,21 +432,30 @@ namespace style {
                 parseIdentifier();
                 return;
             }
-            if (_currentNode->token() != Token::RawName && _currentNode->token() != Token::Int) return;
+            if (_currentToken->token != Token::RawName && _currentToken->token != Token::Int) return;
             _parsedTree->deleteSpecificChild(lastChild);
-            _parsedTree->addChild(new DeserializationNode{Token::Hex, _currentNode->value()});
+            _parsedTree->addChild(newHexNode());
         }
         else {
-            if (_currentNode->token() != Token::RawName && _currentNode->token() != Token::Int) return;
+            if (_currentToken->token != Token::RawName && _currentToken->token != Token::Int) return;
             if (_parsedTree->nbChilds() > 1) throw MalformedExpressionException("Can only have one rvalue in an assignment");
-            _parsedTree->addChild(new DeserializationNode{Token::Hex, _currentNode->value()});
+            _parsedTree->addChild(newHexNode());
         }
     }
 
+    DeserializationNode *Parser::newHexNode() const {
+        Number color;
+        if (!decodeHexColor(currentValue(), &color.rgbaValue))
+            throw MalformedExpressionException("Hexadecimal color '#" + std::string(currentValue()) + "' must be '#rgb', '#rrggbb' or '#rrggbbaa'");
+        DeserializationNode *node = newNode(Token::Hex);
+        node->number(color);
+        return node;
+    }
+
     void Parser::parseDot() {
         removeSpace();
-        if (_currentNode->next()->token() == Token::RawName) {
-            _currentNode = _currentNode->next();
+        if (nextToken() != nullptr && nextToken()->token == Token::RawName) {
+            advance();
             parseClass();
         }
         else throw MalformedExpressionException("Illegal '.' placement");
@@ -260,20 +463,14 @@ namespace style {
 
     void Parser::parseAmpersand() {
         DeserializationNode *lastChild;
-        DeserializationNode *lastChildCopy = nullptr;
+        DeserializationNode *movedLastChild = nullptr;
         Token token = _parsedTree->token();
         if (token == Token::NullRoot || token == Token::BlockDeclarations) {
             lastChild = _parsedTree->getLastChild();
-            if (lastChild != nullptr) {
-                if (isWhiteSpace(lastChild->token())) {
-                    removeWhiteSpaces();
-                    lastChild = nullptr;
-                }
-                else if (lastChild->token() == Token::Name) lastChildCopy = new DeserializationNode{Token::ElementName, lastChild->value()};
-                else if (lastChild->token() == Token::AnyParent)
-                    ; // do nothing, just ensure the node is being removed without being copied before
-                else lastChildCopy = lastChild->copyNodeWithChilds();
-                _parsedTree->deleteSpecificChild(lastChild);
+            if (trailingWhiteSpaces()) removeWhiteSpaces();
+            else if (lastChild != nullptr) {
+                if (lastChild->token() == Token::AnyParent) _parsedTree->deleteSpecificChild(lastChild);
+                else movedLastChild = moveLastDeclarationComponent(lastChild);
             }
             else {
                 if (token == Token::NullRoot)
@@ -282,7 +479,7 @@ namespace style {
             _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                               ->addChild(new DeserializationNode(Token::BlockSelectors))
                               ->addChild(new DeserializationNode(Token::Selector));
-            _parsedTree->addChild(lastChildCopy);
+            _parsedTree->addChild(movedLastChild);
             _parsedTree->addChild(new DeserializationNode(Token::SameElement));
         }
         else if (token == Token::Selector) {
@@ -300,9 +497,8 @@ namespace style {
 
     void Parser::parseAt() {
         if (_parsedTree->token() != Token::NullRoot) throw MalformedExpressionException("A '@' (at) token must be on the root level");
-        _currentNode = _currentNode->next();
-        if (_currentNode == nullptr) throw MalformedExpressionException("A '@' (at) token must not be alone");
-        if (_currentNode->token() == Token::RawName && _currentNode->value() == "import") {
+        if (!advance()) throw MalformedExpressionException("A '@' (at) token must not be alone");
+        if (_currentToken->token == Token::RawName && currentValue() == "import") {
             removeWhiteSpaces();
             _parsedTree = _parsedTree->addChild(new DeserializationNode{Token::Import});
         }
@@ -326,30 +522,24 @@ namespace style {
 
     void Parser::parseString() {
         if (_parsedTree->token() == Token::Import) {
-            if (_parsedTree->getLastChild()->token() != Token::Space)
+            if (!(trailingWhiteSpaces() & PRECEDED_BY_SPACE))
                 throw MalformedExpressionException("A space is needed between '@import' and the file name");
             removeSpace();
-            _parsedTree->value(_currentNode->value());
+            _parsedTree->value(currentValue());
         }
         else parseValue();
     }
 
     void Parser::parseGreatherThan() {
         DeserializationNode *lastChild;
-        DeserializationNode *lastChildCopy = nullptr;
+        DeserializationNode *movedLastChild = nullptr;
         Token token = _parsedTree->token();
         if (token == Token::NullRoot || token == Token::BlockDeclarations) {
             lastChild = _parsedTree->getLastChild();
-            if (lastChild != nullptr) {
-                if (isWhiteSpace(lastChild->token())) {
-                    removeWhiteSpaces();
-                    lastChild = nullptr;
-                }
-                else if (lastChild->token() == Token::Name) lastChildCopy = new DeserializationNode{Token::ElementName, lastChild->value()};
-                else if (lastChild->token() == Token::AnyParent)
-                    ; // do nothing, just ensure the node is being removed without being copied before
-                else lastChildCopy = lastChild->copyNodeWithChilds();
-                _parsedTree->deleteSpecificChild(lastChild);
+            if (trailingWhiteSpaces()) removeWhiteSpaces();
+            else if (lastChild != nullptr) {
+                if (lastChild->token() == Token::AnyParent) _parsedTree->deleteSpecificChild(lastChild);
+                else movedLastChild = moveLastDeclarationComponent(lastChild);
             }
             else {
                 if (token == Token::NullRoot)
@@ -358,7 +548,7 @@ namespace style {
             _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                               ->addChild(new DeserializationNode(Token::BlockSelectors))
                               ->addChild(new DeserializationNode(Token::Selector));
-            _parsedTree->addChild(lastChildCopy);
+            _parsedTree->addChild(movedLastChild);
             _parsedTree->addChild(new DeserializationNode(Token::DirectParent));
         }
         else if (token == Token::Selector) {
@@ -382,7 +572,7 @@ namespace style {
             if (_parsedTree->nbChilds() > 1) {
                 lastChild = _parsedTree->getLastChild();
                 if (lastChild != nullptr && lastChild->token() == Token::Name) {
-                    _parsedTree->replaceChild(lastChild, new DeserializationNode{Token::Function, lastChild->value()});
+                    lastChild->token(Token::Function);
                 }
                 else throw MalformedExpressionException("A tuple must be the only right value of an assignment");
             }
@@ -415,8 +605,7 @@ namespace style {
 
     void Parser::parseOpeningCurlyBracket() {
         DeserializationNode *lastChild;
-        DeserializationNode *lastChildCopy;
-        removeSpace();
+        removeWhiteSpaces();
         lastChild = _parsedTree->getLastChild();
         if (lastChild != nullptr && lastChild->token() == Token::AnyParent) {
             _parsedTree->deleteSpecificChild(lastChild);
@@ -428,13 +617,11 @@ namespace style {
             if (lastChild == nullptr)
                 throw MalformedExpressionException(
                     "A style block must start with at list an element name|class|identifier before the opening curly bracket");
-            lastChildCopy = lastChild->copyNodeWithChilds();
-            if (lastChildCopy->token() == Token::Name) lastChildCopy->token(Token::ElementName);
-            _parsedTree->deleteSpecificChild(lastChild);
+            lastChild = moveLastDeclarationComponent(lastChild);
             _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                               ->addChild(new DeserializationNode(Token::BlockSelectors))
                               ->addChild(new DeserializationNode(Token::Selector));
-            _parsedTree->addChild(lastChildCopy);
+            _parsedTree->addChild(lastChild);
         }
         _parsedTree = _parsedTree->parent()->parent()->addChild(new DeserializationNode(Token::BlockDeclarations));
     }
@@ -456,7 +643,7 @@ namespace style {
             removeSpace();
 
             if (_parsedTree->nbChilds() != 1) throw MalformedExpressionException("Can only have one rvalue in an assignment");
-            _parsedTree->addChild(new DeserializationNode{Token::EnumValue, _currentNode->value()});
+            _parsedTree->addChild(newNode(Token::EnumValue));
         }
         else if (_parsedTree->token() == Token::Tuple || _parsedTree->token() == Token::Function) {
             removeSpace();
@@ -465,10 +652,10 @@ namespace style {
             if (lastChild != nullptr && lastChild->token() != Token::ArgSeparator)
                 throw MalformedExpressionException("The elements in a tuple or the parameters of a function must be comma separated");
             _parsedTree->deleteSpecificChild(lastChild);
-            _parsedTree->addChild(new DeserializationNode{Token::EnumValue, _currentNode->value()});
+            _parsedTree->addChild(newNode(Token::EnumValue));
         }
         else {
-            if (isValidElementOrRuleName(_currentNode->value())) parseName();
+            if (isValidElementOrRuleName(currentValue())) parseName();
             else throw MalformedExpressionException("Illegal raw name placement");
         }
     }
@@ -476,14 +663,13 @@ namespace style {
     void Parser::parseName() {
         Token token = _parsedTree->token();
         DeserializationNode *lastChild;
-        DeserializationNode *lastChildCopy;
         if (token == Token::NullRoot) {
             removeWhiteSpaces();
 
             _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                               ->addChild(new DeserializationNode(Token::BlockSelectors))
                               ->addChild(new DeserializationNode(Token::Selector));
-            _parsedTree->addChild(new DeserializationNode{Token::ElementName, _currentNode->value()});
+            _parsedTree->addChild(newNode(Token::ElementName));
             return;
         }
         if (token == Token::BlockDeclarations) {
@@ -491,15 +677,14 @@ namespace style {
             lastChild = _parsedTree->getLastChild();
 
             if (lastChild != nullptr && lastChild->token() == Token::RawName) {
-                lastChildCopy = lastChild->copyNodeWithChilds();
-                _parsedTree->deleteSpecificChild(lastChild);
+                _parsedTree->detachChild(lastChild);
                 _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                                   ->addChild(new DeserializationNode(Token::BlockSelectors))
                                   ->addChild(new DeserializationNode(Token::Selector));
-                _parsedTree->addChild(lastChildCopy);
-                _parsedTree->addChild(new DeserializationNode{Token::ElementName, _currentNode->value()});
+                _parsedTree->addChild(lastChild);
+                _parsedTree->addChild(newNode(Token::ElementName));
             }
-            else _parsedTree->addChild(new DeserializationNode{Token::Name, _currentNode->value()});
+            else _parsedTree->addChild(newNode(Token::Name));
             return;
         }
 
@@ -507,11 +692,11 @@ namespace style {
             removeSpace();
 
             if (_parsedTree->nbChilds() > 1) throw MalformedExpressionException("A string|function must be the only right value of an assignment");
-            _parsedTree->addChild(new DeserializationNode{Token::Name, _currentNode->value()});
+            _parsedTree->addChild(newNode(Token::Name));
             return;
         }
         if (token == Token::Selector) {
-            _parsedTree->addChild(new DeserializationNode{Token::ElementName, _currentNode->value()});
+            _parsedTree->addChild(newNode(Token::ElementName));
             return;
         }
         removeSpace();
@@ -522,7 +707,7 @@ namespace style {
         if (lastChild != nullptr && lastChild->token() != Token::ArgSeparator)
             throw MalformedExpressionException("The elements in a tuple or the parameters of a function must be comma separated");
         _parsedTree->deleteSpecificChild(lastChild);
-        _parsedTree->addChild(_currentNode->copyNode());
+        _parsedTree->addChild(newNode(_currentToken->token));
     }
 
     void Parser::parseUnit() {
@@ -532,42 +717,41 @@ namespace style {
             throw MalformedExpressionException("An unit must be inside an assignment, a function or a tuple");
 
         lastChild = _parsedTree->getLastChild();
-        if (lastChild == nullptr || (lastChild->token() != Token::Int && lastChild->token() != Token::Float))
+        if (trailingWhiteSpaces() || lastChild == nullptr || (lastChild->token() != Token::Int && lastChild->token() != Token::Float))
             throw MissingTokenException("A unit must have an int or a float before");
-        newChild = new DeserializationNode{_currentNode->token(), _currentNode->value()};
-        newChild->addChild(lastChild->copyNodeWithChilds());
-        _parsedTree->replaceChild(lastChild, newChild);
+        // the number is moved in the unit, which takes its place
+        newChild = newNode(_currentToken->token);
+        newChild->addChild(_parsedTree->detachChild(lastChild));
+        _parsedTree->addChild(newChild);
+    }
+
+    DeserializationNode *Parser::moveLastDeclarationComponent(DeserializationNode *lastChild) {
+        _parsedTree->detachChild(lastChild);
+        if (lastChild->token() == Token::Name) lastChild->token(Token::ElementName);
+        return lastChild;
     }
 
     DeserializationNode *Parser::updateLastDeclarationComponentBeforeNewOne(DeserializationNode *lastChild) {
-        DeserializationNode *finalChild = nullptr;
-        if (lastChild != nullptr) {
-            if (isWhiteSpace(lastChild->token())) {
-                removeWhiteSpaces();
-                lastChild = nullptr;
-            }
-            else if (lastChild->token() == Token::Name) finalChild = new DeserializationNode{Token::ElementName, lastChild->value()};
-            else finalChild = lastChild->copyNodeWithChilds();
-            _parsedTree->deleteSpecificChild(lastChild);
-        }
-        return finalChild;
+        if (trailingWhiteSpaces()) removeWhiteSpaces();
+        else if (lastChild != nullptr) return moveLastDeclarationComponent(lastChild);
+        return nullptr;
     }
 
     void Parser::parseDeclarationComponent(Token outputTokenType) {
         DeserializationNode *lastChild;
-        DeserializationNode *lastChildCopy = nullptr;
+        DeserializationNode *movedLastChild;
         Token token = _parsedTree->token();
         if (token == Token::NullRoot || token == Token::BlockDeclarations) {
             lastChild = _parsedTree->getLastChild();
-            lastChildCopy = updateLastDeclarationComponentBeforeNewOne(lastChild);
+            movedLastChild = updateLastDeclarationComponentBeforeNewOne(lastChild);
             _parsedTree = _parsedTree->addChild(new DeserializationNode(Token::StyleBlock))
                               ->addChild(new DeserializationNode(Token::BlockSelectors))
                               ->addChild(new DeserializationNode(Token::Selector));
-            _parsedTree->addChild(lastChildCopy);
-            _parsedTree->addChild(new DeserializationNode{outputTokenType, _currentNode->value()});
+            _parsedTree->addChild(movedLastChild);
+            _parsedTree->addChild(newNode(outputTokenType));
         }
         else if (token == Token::Selector) {
-            _parsedTree->addChild(new DeserializationNode{outputTokenType, _currentNode->value()});
+            _parsedTree->addChild(newNode(outputTokenType));
         }
         else
             throw MalformedExpressionException(
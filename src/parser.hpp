@@ -1,9 +1,16 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
+#include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
 #include "deserialization_node.hpp"
+#include "flat_tree.hpp"
+#include "lexer.hpp"
+#include "token_stream.hpp"
 #include <exception>
+#include <istream>
 #include <string>
+#include <string_view>
 
 namespace style {
 
@@ -17,8 +24,9 @@ namespace style {
 
     class UnknownTokenException : public ParserException {
     public:
-        UnknownTokenException(const DeserializationNode &token)
-            : ParserException{"Unknown token: \"" + token.value() + " (" + tokenToString(token.token()) + ")\""} {};
+        UnknownTokenException(const DeserializationNode &token) : UnknownTokenException{token.token(), token.value()} {};
+        UnknownTokenException(Token token, std::string_view value)
+            : ParserException{"Unknown token: \"" + std::string(value) + " (" + tokenToString(token) + ")\""} {};
     };
 
     class MissingTokenException : public ParserException {
@@ -32,38 +40,120 @@ namespace style {
     };
 
     /**
-     * Transform a chain of trees (no childs) like the one the lexer function returns into a tree containing the entire expression
+     * Transform a list of tokens like the one the lexer returns into a tree containing the entire expression
      */
     class Parser {
-        DeserializationNode *_currentNode = nullptr;
-
+        const TokenStream *_tokens = nullptr;
+        // in pull mode, lexer giving the tokens on demand, nullptr once the whole expression is lexed
+        Lexer *_lexer = nullptr;
+        // lexer of the pull mode, only needing the white spaces as flags
+        Lexer _pullLexer = Lexer(false, false);
+        // intermediate nodes of parseFlat
+        NodeArena _flatNodes;
+        // in pull mode, the tokens from the current one to the lookahead, the previous ones being discarded
+        TokenStream _pulledTokens;
+        /**
+         * White spaces are read as a single Space or LineBreak token between two tokens, whether they were lexed as tokens or as flags,
+         * and comments are skipped.
+         * _currentIndex is the index of the current token, or of the token following them when the current token is white spaces.
+         */
+        size_t _currentIndex = 0;
+        bool _onWhiteSpaces = false;
+        // nullptr once all the tokens are consumed
+        const LexedToken *_currentToken = nullptr;
         /**
-         * The expressionTreeRoot should never contains a pointer pointing to _currentNode in any way,
-         * because it could be used and freed in the calling program after the parser call.
-         * Consider currentNode as const
+         * White spaces (PRECEDED_BY_SPACE, PRECEDED_BY_LINE_BREAK) who would be the last childs of _whiteSpacesParent,
+         * kept as flags instead of Space and LineBreak nodes.
          */
+        uint8_t _trailingWhiteSpaces = 0;
+        const DeserializationNode *_whiteSpacesParent = nullptr;
+        // if false, the nodes of the tree reference the expression of the tokens instead of owning a copy of their values
+        bool _copyValues = false;
+
         // only used to avoid recalculating many times the root
         DeserializationNode *_expressionTreeRoot = nullptr;
         DeserializationNode *_parsedTree = nullptr;
-        static bool isValidName(const std::string &str, size_t start, size_t end);
+        static bool isValidName(std::string_view str, size_t start, size_t end);
 
     public:
-        static bool isValidElementOrRuleName(const std::string &str);
-        DeserializationNode *parse(DeserializationNode *currentNode);
+        static bool isValidElementOrRuleName(std::string_view str);
+        /**
+         * Forget the expression being parsed, so the parser can be used again after an exception.
+         * The memory of the pulled tokens and of the flat tree nodes is kept, parsing many small expressions with the same parser
+         * only allocates the nodes of the returned trees.
+         */
+        void reset();
+        /**
+         * The nodes of the returned tree reference the expression of the tokens, so it must outlive the tree.
+         */
+        DeserializationNode *parse(const TokenStream &tokens);
+        /**
+         * Adapter for a chain of nodes like the one Lexer::lexe returns.
+         * The nodes of the returned tree own their values.
+         */
+        DeserializationNode *parse(const DeserializationNode *currentNode);
+        /**
+         * Pull mode: the expression is lexed while being parsed, each token being discarded once parsed,
+         * so only a few tokens are alive at the same time instead of the whole list.
+         * On a parser error, the rest of the expression is lexed so an error of the lexer is thrown first, as when the tokens are lexed before.
+         * The nodes of the returned tree reference the expression, so it must outlive the tree.
+         */
+        DeserializationNode *parse(std::string_view expression, const config::Config *config);
+        /**
+         * Same as parse in pull mode, the lexer using the units compiled once in the config
+         */
+        DeserializationNode *parse(std::string_view expression, const config::CompiledConfig *config);
+        /**
+         * Pull mode on an input read by chunks (see Lexer::startStream): only the tokens from the current one to the lookahead are alive,
+         * with their values, so the memory used by the tokens doesn't depend on the size of the input.
+         * The nodes of the returned tree own their values.
+         */
+        DeserializationNode *parse(const ReadCallback &read, const config::CompiledConfig *config, size_t chunkSize = DEFAULT_STREAM_CHUNK_SIZE);
+        DeserializationNode *parse(std::istream &input, const config::CompiledConfig *config, size_t chunkSize = DEFAULT_STREAM_CHUNK_SIZE);
+        /**
+         * In pull mode, the tokens alive, from the current one to the lookahead
+         */
+        const TokenStream &pulledTokens() const { return _pulledTokens; }
+        /**
+         * Parse the expression in pull mode and copy the tree in a FlatTree,
+         * the intermediate nodes being allocated in an arena released at once.
+         * The parser rewrites its tree in place while parsing, so it doesn't emit the flat nodes directly:
+         * parsing a flat tree costs the nodes of the tree and a traversal more than parse.
+         */
+        FlatTree parseFlat(std::string_view expression, const config::Config *config);
 
     private:
-        static bool isWhiteSpace(Token token);
+        DeserializationNode *parseTokens();
+        // parse the tokens pulled from the started lexer
+        DeserializationNode *parsePulledTokens();
+        // parse the expression the lexer was started on
+        DeserializationNode *parseExpression(std::string_view expression);
+        std::string_view currentValue() const { return _tokens->value(*_currentToken); }
+        // in pull mode, lexe the tokens until the one at index, return false if there is no token at index
+        bool hasToken(size_t index);
+        // index of the first token from index who isn't a white space or a comment, the skipped white spaces being added to whiteSpaces
+        size_t skipWhiteSpaces(size_t index, uint8_t *whiteSpaces);
+        // go to the white spaces before the token at index if there are some, else to the token
+        void moveTo(size_t index, uint8_t whiteSpaces);
+        // nullptr if there is no next token
+        const LexedToken *nextToken();
+        // go to the next token, return false if there is no next token
+        bool advance();
+        // create a node with the value of the current token
+        DeserializationNode *newNode(Token token) const;
+        // create a Hex node with the decoded color of the current token, throw if it isn't a valid color
+        DeserializationNode *newHexNode() const;
         // relations are direct parent, any parent, same element, ...
         static bool isComponentRelation(Token token);
+        uint8_t trailingWhiteSpaces() const { return (_whiteSpacesParent == _parsedTree) ? _trailingWhiteSpaces : 0; }
+        void addTrailingWhiteSpaces(uint8_t whiteSpaces);
         void removeSpace();
         void removeLineReturn();
-        // removes all spaces and line returns childs
+        // removes all trailing spaces and line returns
         void removeWhiteSpaces();
 
         void parseSpace();
         void parseLineBreak();
-        void parseOneLineComment();
-        void parseMultiLineComment();
         void parseValue();
         void parseComma();
         void parseColon();
@@ -83,6 +173,8 @@ namespace style {
         void parseName();
         void parseUnit();
 
+        // detach the last child to move it in a new selector, a name becoming an element name
+        DeserializationNode *moveLastDeclarationComponent(DeserializationNode *lastChild);
         // if you don't know how to use it, don't use it
         DeserializationNode *updateLastDeclarationComponentBeforeNewOne(DeserializationNode *lastChild);
         void parseDeclarationComponent(Token outputTokenType);
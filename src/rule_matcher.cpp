@@ -0,0 +1,103 @@
+#include "rule_matcher.hpp"
+
+namespace style::config {
+
+    RuleMatcher::RuleMatcher(const std::vector<const ConfigRuleNode *> &alternatives) {
+        addState();
+        for (const ConfigRuleNode *alternative : alternatives) {
+            if (alternative == nullptr) _states[0].accepting = true;
+            else _states[addNodes(0, alternative)].accepting = true;
+        }
+    }
+
+    uint32_t RuleMatcher::addState() {
+        _states.emplace_back();
+        return _states.size() - 1;
+    }
+
+    uint32_t RuleMatcher::addOpen(uint32_t state, const ConfigRuleNode *node) {
+        Token token = node->token();
+        uint32_t enumValues = NO_ENUM;
+        uint32_t opened = NO_STATE;
+        uint32_t next;
+
+        if (token == Token::EnumValue) {
+            // an enum node who isn't a ConfigRuleNodeEnum allows no value
+            const ConfigRuleNodeEnum *enumNode = dynamic_cast<const ConfigRuleNodeEnum *>(node);
+            std::unordered_set<std::string_view> values;
+            if (enumNode != nullptr) values.insert(enumNode->allowedValues().cbegin(), enumNode->allowedValues().cend());
+            for (enumValues = 0; enumValues < _enumValues.size() && _enumValues[enumValues] != values; enumValues++) {
+            }
+            if (enumValues == _enumValues.size()) _enumValues.push_back(std::move(values));
+        }
+        // the alternatives opening the same node share the transition
+        for (const Transition &transition : _states[state].opens) {
+            if (transition.token == token && transition.enumValues == enumValues) opened = transition.state;
+        }
+        if (opened == NO_STATE) {
+            opened = addState();
+            _states[state].opens.push_back({token, enumValues, opened});
+        }
+
+        if (node->child() == nullptr || (token != Token::Tuple && token != Token::Function && token != Token::Unit)) {
+            if (_states[opened].skip == NO_STATE) {
+                next = addState();
+                _states[opened].skip = next;
+            }
+            return _states[opened].skip;
+        }
+        state = addNodes(opened, node->child());
+        if (_states[state].close == NO_STATE) {
+            next = addState();
+            _states[state].close = next;
+        }
+        return _states[state].close;
+    }
+
+    uint32_t RuleMatcher::addNodes(uint32_t state, const ConfigRuleNode *nodes) {
+        for (; nodes != nullptr; nodes = nodes->next()) {
+            state = addOpen(state, nodes);
+        }
+        return state;
+    }
+
+    void RuleMatcher::Match::start(const RuleMatcher *matcher) {
+        _matcher = matcher;
+        _states.assign(1, {0, 0});
+    }
+
+    void RuleMatcher::Match::open(Token token, std::string_view value) {
+        _nextStates.clear();
+        for (const std::pair<uint32_t, uint32_t> &state : _states) {
+            if (state.second > 0) {
+                _nextStates.emplace_back(state.first, state.second + 1);
+                continue;
+            }
+            for (const Transition &transition : _matcher->_states[state.first].opens) {
+                if (transition.token != token) continue;
+                if (transition.enumValues != NO_ENUM && _matcher->_enumValues[transition.enumValues].count(value) == 0) continue;
+                const State &opened = _matcher->_states[transition.state];
+                if (!opened.opens.empty()) _nextStates.emplace_back(transition.state, 0);
+                if (opened.skip != NO_STATE) _nextStates.emplace_back(opened.skip, 1);
+            }
+        }
+        _states.swap(_nextStates);
+    }
+
+    void RuleMatcher::Match::close() {
+        _nextStates.clear();
+        for (const std::pair<uint32_t, uint32_t> &state : _states) {
+            if (state.second > 0) _nextStates.emplace_back(state.first, state.second - 1);
+            else if (_matcher->_states[state.first].close != NO_STATE) _nextStates.emplace_back(_matcher->_states[state.first].close, 0);
+        }
+        _states.swap(_nextStates);
+    }
+
+    bool RuleMatcher::Match::matched() const {
+        for (const std::pair<uint32_t, uint32_t> &state : _states) {
+            if (state.second == 0 && _matcher->_states[state.first].accepting) return true;
+        }
+        return false;
+    }
+
+} // namespace style::config
@@ -0,0 +1,83 @@
+#ifndef RULE_MATCHER_HPP
+#define RULE_MATCHER_HPP
+
+#include "abstract_configuration.hpp"
+#include "tokens.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace style::config {
+
+    /**
+     * Validator of the values of a rule, built from all its alternatives in the config.
+     * A value is matched in a single pass on its nodes in pre-order, each node being opened then closed after its childs.
+     * The alternatives are merged in a decision tree sharing their common starts, so each node of a value is compared once with the
+     * alternatives starting the same way instead of trying them one after another.
+     * The childs of a tuple, a function or a unit must match the childs of its config node, any childs being accepted if it has none.
+     */
+    class RuleMatcher {
+        static constexpr uint32_t NO_STATE = UINT32_MAX;
+        static constexpr uint32_t NO_ENUM = UINT32_MAX;
+
+        struct Transition {
+            Token token;
+            // index of the allowed values in _enumValues for an enum, NO_ENUM for the other tokens
+            uint32_t enumValues;
+            uint32_t state;
+        };
+
+        struct State {
+            // nodes which can be opened from this state
+            std::vector<Transition> opens;
+            // state after the childs of the opened node, whatever they are, and its closing
+            uint32_t skip = NO_STATE;
+            // state after the closing of the opened node, once its childs matched
+            uint32_t close = NO_STATE;
+            // a value can end here
+            bool accepting = false;
+        };
+
+        // the first state is the one before the value
+        std::vector<State> _states;
+        // referencing the strings of the config
+        std::vector<std::unordered_set<std::string_view>> _enumValues;
+
+        uint32_t addState();
+        uint32_t addOpen(uint32_t state, const ConfigRuleNode *node);
+        // add the node and its nexts after the state, returning the state after the last one
+        uint32_t addNodes(uint32_t state, const ConfigRuleNode *nodes);
+
+    public:
+        /**
+         * Progress of the match of a value, which can be kept to match other values without allocating
+         */
+        class Match {
+            const RuleMatcher *_matcher = nullptr;
+            // the states reached by the value, with the number of opened nodes whose childs are skipped before reaching them
+            std::vector<std::pair<uint32_t, uint32_t>> _states;
+            std::vector<std::pair<uint32_t, uint32_t>> _nextStates;
+
+        public:
+            void start(const RuleMatcher *matcher);
+            // the value is only read for the enum values
+            void open(Token token, std::string_view value);
+            void close();
+            // no more node can make the value valid
+            bool failed() const { return _states.empty(); }
+            // the nodes since start make a valid value
+            bool matched() const;
+        };
+
+        /**
+         * A nullptr alternative accepts a rule without value
+         */
+        RuleMatcher(const std::vector<const ConfigRuleNode *> &alternatives);
+    };
+
+} // namespace style::config
+
+#endif // RULE_MATCHER_HPP
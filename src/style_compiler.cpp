@@ -0,0 +1,436 @@
+#include "style_compiler.hpp"
+#include "number.hpp"
+#include "parser.hpp"
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+namespace style {
+
+    namespace {
+        // thrown on the constructs left to NodesToStyleComponents
+        class UnsupportedConstructException : public std::exception {
+        public:
+            const char *what() const noexcept override { return "construct not handled by the style compiler"; }
+        };
+
+        bool isComponentRelation(Token token) { return token == Token::AnyParent || token == Token::DirectParent; }
+
+        // the tuples are compiled recursively, the deeper ones are left to NodesToStyleComponents whose conversion doesn't recurse
+        constexpr int MAX_TUPLE_DEPTH = 64;
+    } // namespace
+
+    bool StyleCompiler::advance() {
+        if (_hasNextToken) {
+            _token = _nextToken;
+            _hasNextToken = false;
+            return true;
+        }
+        if (_lexer == nullptr) return false;
+        if (_lexer->nextToken(&_token)) return true;
+        _lexer = nullptr;
+        return false;
+    }
+
+    void StyleCompiler::advanceInBlock() {
+        if (!advance()) throw UnsupportedConstructException();
+        // Parser refuses the line breaks everywhere except between the blocks and the assignments
+        if (_token.flags & PRECEDED_BY_LINE_BREAK) throw UnsupportedConstructException();
+    }
+
+    const LexedToken *StyleCompiler::peek() {
+        if (!_hasNextToken && _lexer != nullptr) {
+            _hasNextToken = _lexer->nextToken(&_nextToken);
+            if (!_hasNextToken) _lexer = nullptr;
+        }
+        return _hasNextToken ? &_nextToken : nullptr;
+    }
+
+    std::string_view StyleCompiler::expectName() {
+        if (!advance() || _token.token != Token::RawName || _token.flags) throw UnsupportedConstructException();
+        return value(_token);
+    }
+
+    void StyleCompiler::compileStyle(std::string_view style, int *ruleNumber) {
+        Lexer lexer(false, false);
+        Lexer *oldLexer = _lexer;
+        std::string_view oldExpression = _expression;
+        LexedToken oldToken = _token;
+        LexedToken oldNextToken = _nextToken;
+        bool oldHasNextToken = _hasNextToken;
+        std::vector<SelectorParts> selectors;
+        // a selector start without line break before it would be moved in the previous block or import by Parser
+        bool hasPreviousBlock = false;
+
+        lexer.start(style, _config);
+        _lexer = &lexer;
+        _expression = style;
+        _hasNextToken = false;
+        while (advance()) {
+            selectors.assign(1, SelectorParts());
+            switch (_token.token) {
+            case Token::At:
+                compileImport(ruleNumber);
+                hasPreviousBlock = true;
+                continue;
+            case Token::Dot:
+            case Token::Sharp:
+            case Token::Colon:
+                if (hasPreviousBlock && !(_token.flags & PRECEDED_BY_LINE_BREAK)) throw UnsupportedConstructException();
+                break;
+            case Token::RawName:
+            case Token::Star:
+                break;
+            default:
+                throw UnsupportedConstructException();
+            }
+            addSelectorPart(&selectors.back());
+            advanceInBlock();
+            compileSelectors(&selectors);
+            compileTopLevelBlock(&selectors, ruleNumber);
+            hasPreviousBlock = true;
+        }
+        _lexer = oldLexer;
+        _expression = oldExpression;
+        _token = oldToken;
+        _nextToken = oldNextToken;
+        _hasNextToken = oldHasNextToken;
+    }
+
+    void StyleCompiler::compileImport(int *ruleNumber) {
+        std::string fileName;
+        std::ostringstream content;
+
+        if (expectName() != "import") throw UnsupportedConstructException();
+        if (!advance() || _token.token != Token::String || _token.flags != PRECEDED_BY_SPACE) throw UnsupportedConstructException();
+        fileName = value(_token);
+        advanceInBlock();
+        if (_token.token != Token::SemiColon) throw UnsupportedConstructException();
+
+        std::ifstream file(fileName);
+        if (!file.is_open()) throw UnsupportedConstructException();
+        content << file.rdbuf();
+        compileStyle(content.str(), ruleNumber);
+    }
+
+    void StyleCompiler::compileTopLevelBlock(std::vector<SelectorParts> *selectors, int *ruleNumber) {
+        compileBlock({nullptr, std::move(*selectors)});
+        addBlocksDefinitions(ruleNumber);
+    }
+
+    void StyleCompiler::addSelectorPart(SelectorParts *selector) {
+        switch (_token.token) {
+        case Token::RawName:
+            if (!Parser::isValidElementOrRuleName(value(_token))) throw UnsupportedConstructException();
+            selector->emplace_back(Token::ElementName, value(_token));
+            break;
+        case Token::Dot:
+            selector->emplace_back(Token::Class, expectName());
+            break;
+        case Token::Sharp:
+            selector->emplace_back(Token::Identifier, expectName());
+            break;
+        case Token::Colon:
+            selector->emplace_back(Token::Modifier, expectName());
+            break;
+        case Token::Star:
+            selector->emplace_back(Token::StarWildcard, std::string_view());
+            break;
+        case Token::Ampersand:
+        case Token::GreaterThan:
+            if (selector->empty()) throw UnsupportedConstructException();
+            if (selector->back().first == Token::AnyParent) selector->pop_back();
+            selector->emplace_back(_token.token == Token::Ampersand ? Token::SameElement : Token::DirectParent, std::string_view());
+            break;
+        default:
+            throw UnsupportedConstructException();
+        }
+    }
+
+    void StyleCompiler::compileSelectors(std::vector<SelectorParts> *selectors) {
+        while (true) {
+            SelectorParts &selector = selectors->back();
+            if ((_token.flags & PRECEDED_BY_SPACE) && !selector.empty() && !isComponentRelation(selector.back().first))
+                selector.emplace_back(Token::AnyParent, std::string_view());
+            if (_token.token == Token::Comma) {
+                if (selector.empty()) throw UnsupportedConstructException();
+                selectors->emplace_back();
+            }
+            else if (_token.token == Token::OpeningCurlyBracket) {
+                if (selector.empty()) throw UnsupportedConstructException();
+                if (selector.back().first == Token::AnyParent) selector.pop_back();
+                return;
+            }
+            else addSelectorPart(&selector);
+            advanceInBlock();
+        }
+    }
+
+    void StyleCompiler::compileBlock(const SelectorsGroup &selectors) {
+        size_t block = _blocks.size();
+        std::vector<SelectorParts> nestedSelectors;
+        // a name which isn't followed by a colon nor a curly bracket, either moved in the next selector or left alone in the block
+        std::string_view name;
+        // the last child of the block in Parser, which is moved in a selector starting without white spaces before it
+        bool hasContent = false;
+        bool movesLastContent;
+
+        _blocks.push_back({NodesToStyleComponents::expandSelectors(selectors), new StyleValuesMap(), 0});
+
+        if (!advance()) throw UnsupportedConstructException();
+        while (_token.token != Token::ClosingCurlyBracket) {
+            nestedSelectors.assign(1, SelectorParts());
+            switch (_token.token) {
+            case Token::RawName:
+                if (!Parser::isValidElementOrRuleName(value(_token))) throw UnsupportedConstructException();
+                name = value(_token);
+                if (!advance()) throw UnsupportedConstructException();
+                if (_token.token == Token::Colon && !(_token.flags & PRECEDED_BY_LINE_BREAK)) {
+                    compileAssignment(name, block);
+                    break;
+                }
+                if (_token.token == Token::OpeningCurlyBracket) {
+                    nestedSelectors.back().emplace_back(Token::ElementName, name);
+                    compileNestedBlock(selectors, &nestedSelectors);
+                    break;
+                }
+                // the token after the name is compiled with the name as last content
+                hasContent = true;
+                continue;
+            case Token::Dot:
+            case Token::Sharp:
+            case Token::Colon:
+            case Token::Star:
+            case Token::Ampersand:
+            case Token::GreaterThan:
+                if (_token.token == Token::Star) movesLastContent = false;
+                else if (_token.token == Token::Ampersand || _token.token == Token::GreaterThan) movesLastContent = !_token.flags;
+                else movesLastContent = !(_token.flags & PRECEDED_BY_LINE_BREAK);
+                if (hasContent && movesLastContent) {
+                    // only a name can start a selector
+                    if (name.empty()) throw UnsupportedConstructException();
+                    nestedSelectors.back().emplace_back(Token::ElementName, name);
+                }
+                if (_token.token == Token::Ampersand || _token.token == Token::GreaterThan) {
+                    nestedSelectors.back().emplace_back(_token.token == Token::Ampersand ? Token::SameElement : Token::DirectParent,
+                                                        std::string_view());
+                }
+                else addSelectorPart(&nestedSelectors.back());
+                advanceInBlock();
+                compileSelectors(&nestedSelectors);
+                compileNestedBlock(selectors, &nestedSelectors);
+                break;
+            default:
+                throw UnsupportedConstructException();
+            }
+            // a name not moved in the selector after it is ignored by the conversion
+            name = std::string_view();
+            hasContent = true;
+            if (!advance()) throw UnsupportedConstructException();
+        }
+        // Parser refuses a block ending with a name
+        if (!name.empty()) throw UnsupportedConstructException();
+    }
+
+    void StyleCompiler::compileNestedBlock(const SelectorsGroup &parentSelectors, std::vector<SelectorParts> *selectors) {
+        compileBlock({&parentSelectors, std::move(*selectors)});
+    }
+
+    void StyleCompiler::compileAssignment(std::string_view ruleName, size_t block) {
+        Token token;
+        StyleValue *styleValue;
+
+        advanceInBlock();
+        styleValue = compileValue(&token);
+        try {
+            advanceInBlock();
+        }
+        catch (const std::exception &) {
+            delete styleValue;
+            throw;
+        }
+        if (_token.token != Token::SemiColon) {
+            delete styleValue;
+            throw UnsupportedConstructException();
+        }
+        if (ruleValid(ruleName, styleValue)) {
+            CompiledBlock &compiledBlock = _blocks[block];
+            compiledBlock.rules->insert_or_assign(std::string(ruleName), StyleRule(styleValue, true, _fileNumber, compiledBlock.rulesCount));
+            compiledBlock.rulesCount++;
+        }
+        delete styleValue;
+    }
+
+    StyleValue *StyleCompiler::compileValue(Token *token, int tupleDepth) {
+        StyleValue *styleValue;
+        StyleValue *unit;
+        Number color;
+        const LexedToken *nextToken;
+
+        *token = _token.token;
+        switch (_token.token) {
+        case Token::Int:
+        case Token::Float:
+            styleValue = new StyleValue(std::string(value(_token)), tokenTypeToStyleValueType(_token.token));
+            styleValue->number(_token.number);
+            nextToken = peek();
+            if (nextToken == nullptr || nextToken->token != Token::Unit) return styleValue;
+            // Parser refuses white spaces between a number and its unit
+            if (nextToken->flags) {
+                delete styleValue;
+                throw UnsupportedConstructException();
+            }
+            advance();
+            *token = Token::Unit;
+            unit = new StyleValue(std::string(value(_token)), StyleValueType::Unit);
+            unit->number(_token.number);
+            unit->addChild(styleValue);
+            return unit;
+        case Token::Bool:
+        case Token::String:
+            styleValue = new StyleValue(std::string(value(_token)), tokenTypeToStyleValueType(_token.token));
+            styleValue->number(_token.number);
+            return styleValue;
+        case Token::RawName:
+            *token = Token::EnumValue;
+            styleValue = new StyleValue(std::string(value(_token)), StyleValueType::EnumValue);
+            styleValue->number(_token.number);
+            return styleValue;
+        case Token::Sharp:
+            // Parser ignores the '#' when it isn't directly followed by the color
+            if (!advance() || (_token.token != Token::RawName && _token.token != Token::Int) || _token.flags) throw UnsupportedConstructException();
+            if (!decodeHexColor(value(_token), &color.rgbaValue)) throw UnsupportedConstructException();
+            *token = Token::Hex;
+            styleValue = new StyleValue(std::string(value(_token)), StyleValueType::Hex);
+            styleValue->number(color);
+            return styleValue;
+        case Token::OpeningParenthesis:
+            *token = Token::Tuple;
+            if (tupleDepth == MAX_TUPLE_DEPTH) throw UnsupportedConstructException();
+            return compileTuple(tupleDepth + 1);
+        default:
+            throw UnsupportedConstructException();
+        }
+    }
+
+    StyleValue *StyleCompiler::compileTuple(int depth) {
+        StyleValue *firstValue = nullptr;
+        StyleValue *lastValue = nullptr;
+        StyleValue *styleValue;
+        StyleValue *tuple;
+        Token token;
+
+        try {
+            advanceInBlock();
+            // only the tuples whose elements are all separated by a single comma, Parser skips the empty ones
+            if (_token.token != Token::ClosingParenthesis) {
+                while (true) {
+                    styleValue = compileValue(&token, depth);
+                    if (lastValue != nullptr) lastValue->next(styleValue);
+                    else firstValue = styleValue;
+                    lastValue = styleValue;
+                    advanceInBlock();
+                    if (_token.token == Token::ClosingParenthesis) break;
+                    if (_token.token != Token::Comma) throw UnsupportedConstructException();
+                    advanceInBlock();
+                }
+            }
+        }
+        catch (const std::exception &) {
+            delete firstValue;
+            throw;
+        }
+        tuple = new StyleValue("", StyleValueType::Tuple);
+        tuple->addChild(firstValue);
+        return tuple;
+    }
+
+    bool StyleCompiler::ruleValid(std::string_view ruleName, const StyleValue *value) {
+        uint32_t ruleId = _config->ruleId(ruleName);
+        if (ruleId == config::CompiledConfig::NO_RULE) return false;
+        _ruleMatch.start(&_config->ruleMatcher(ruleId));
+        _valueParents.clear();
+        while (value != nullptr) {
+            _ruleMatch.open(styleValueTypeToTokenType(value->type()), value->value());
+            if (_ruleMatch.failed()) return false;
+            if (value->child() != nullptr) {
+                _valueParents.push_back(value);
+                value = value->child();
+                continue;
+            }
+            _ruleMatch.close();
+            while (value->next() == nullptr && !_valueParents.empty()) {
+                value = _valueParents.back();
+                _valueParents.pop_back();
+                _ruleMatch.close();
+            }
+            value = value->next();
+        }
+        return _ruleMatch.matched();
+    }
+
+    void StyleCompiler::addBlocksDefinitions(int *ruleNumber) {
+        for (CompiledBlock &block : _blocks) {
+            for (std::pair<const std::string, StyleRule> &rule : *block.rules) {
+                rule.second.ruleNumber += *ruleNumber;
+            }
+            *ruleNumber += block.rulesCount;
+            if (block.rules->empty()) {
+                for (StyleComponentDataList *componentDataList : *block.selectors) {
+                    delete componentDataList;
+                }
+                delete block.selectors;
+                delete block.rules;
+            }
+            else _converter.addStyleDefinitions(block.selectors, block.rules);
+        }
+        _blocks.clear();
+    }
+
+    void StyleCompiler::deleteBlocks() {
+        for (CompiledBlock &block : _blocks) {
+            for (StyleComponentDataList *componentDataList : *block.selectors) {
+                delete componentDataList;
+            }
+            delete block.selectors;
+            delete block.rules;
+        }
+        _blocks.clear();
+    }
+
+    void StyleCompiler::abortCompilation() {
+        deleteBlocks();
+        for (StyleDefinition *styleDefinition : *_converter.styleDefinitions) {
+            delete styleDefinition;
+        }
+        delete _converter.styleDefinitions;
+        _converter.styleDefinitions = nullptr;
+        _lexer = nullptr;
+        _hasNextToken = false;
+    }
+
+    std::list<StyleDefinition *> *StyleCompiler::compile(const std::string &style, int fileNumber, int *ruleNumber) {
+        std::list<StyleDefinition *> *styleDefinitions;
+        *ruleNumber = 0;
+        _fileNumber = fileNumber;
+        _converted = false;
+        _converter.styleDefinitions = new std::list<StyleDefinition *>();
+        try {
+            compileStyle(style, ruleNumber);
+        }
+        catch (const UnsupportedConstructException &) {
+            abortCompilation();
+            // converted again from the start, giving the definitions or the error of the pipeline
+            _converted = true;
+            return _converter.convert(style, fileNumber, ruleNumber);
+        }
+        catch (...) {
+            abortCompilation();
+            throw;
+        }
+        styleDefinitions = _converter.styleDefinitions;
+        _converter.styleDefinitions = nullptr;
+        return styleDefinitions;
+    }
+
+} // namespace style
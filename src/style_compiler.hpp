@@ -0,0 +1,105 @@
+#ifndef STYLE_COMPILER_HPP
+#define STYLE_COMPILER_HPP
+
+#include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
+#include "lexer.hpp"
+#include "nodes_to_style_components.hpp"
+#include "style_component.hpp"
+#include "token_stream.hpp"
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace style {
+
+    /**
+     * Compile a style straight to its definitions in a single pass, without building a tree of nodes.
+     * The blocks are parsed by recursive descent, keeping the joined selectors of the enclosing blocks,
+     * and each assignment is validated with the configuration and converted as soon as it is parsed.
+     * A style using a construct whose parsing has side effects in Parser (a selector moving the block before it, a name left alone in a
+     * block, a tuple with empty elements...) or which is malformed is converted by NodesToStyleComponents instead,
+     * so both always give the same definitions or the same parser error.
+     * The other errors (lexer errors, allocation failures...) are raised directly, without converting the style again.
+     */
+    class StyleCompiler {
+        using SelectorParts = NodesToStyleComponents::SelectorParts;
+        using SelectorsGroup = NodesToStyleComponents::SelectorsGroup;
+
+        // a block of the top level block being compiled, its rules are numbered once the top level block is closed
+        struct CompiledBlock {
+            std::list<StyleComponentDataList *> *selectors;
+            StyleValuesMap *rules;
+            // number of valid rules of the block, including the ones overridden by a later rule with the same name
+            int rulesCount;
+        };
+
+        // also converts the styles the compiler doesn't handle
+        NodesToStyleComponents _converter;
+        // the config of the converter
+        const config::CompiledConfig *_config;
+        int _fileNumber = 0;
+        // blocks of the current top level block, in the order of their rules numbers (a block then its nested blocks)
+        std::vector<CompiledBlock> _blocks;
+
+        // pulled tokens of the style being compiled, an import compiles an other style before going back to them
+        Lexer *_lexer = nullptr;
+        std::string_view _expression;
+        LexedToken _token;
+        LexedToken _nextToken;
+        bool _hasNextToken = false;
+        config::RuleMatcher::Match _ruleMatch;
+        std::vector<const StyleValue *> _valueParents;
+        // whether the last style was converted by NodesToStyleComponents
+        bool _converted = false;
+
+        bool advance();
+        // the style can't end on the current token
+        void advanceInBlock();
+        const LexedToken *peek();
+        std::string_view value(const LexedToken &token) const { return _expression.substr(token.start, token.length); }
+        std::string_view expectName();
+
+        void compileStyle(std::string_view style, int *ruleNumber);
+        void compileImport(int *ruleNumber);
+        void compileTopLevelBlock(std::vector<SelectorParts> *selectors, int *ruleNumber);
+        void addSelectorPart(SelectorParts *selector);
+        /**
+         * Parse the next selectors of a block up to its opening curly bracket, the current token being the one after the start of the
+         * last selector
+         */
+        void compileSelectors(std::vector<SelectorParts> *selectors);
+        void compileBlock(const SelectorsGroup &selectors);
+        void compileNestedBlock(const SelectorsGroup &parentSelectors, std::vector<SelectorParts> *selectors);
+        void compileAssignment(std::string_view ruleName, size_t block);
+        // tupleDepth is the number of tuples containing the value
+        StyleValue *compileValue(Token *token, int tupleDepth = 0);
+        StyleValue *compileTuple(int depth);
+        // the whole compiled value is matched like NodesToStyleComponents::ruleValid does with the nodes
+        bool ruleValid(std::string_view ruleName, const StyleValue *value);
+        void addBlocksDefinitions(int *ruleNumber);
+        void deleteBlocks();
+        // delete what was compiled before an exception and forget the tokens
+        void abortCompilation();
+
+    public:
+        /**
+         * Throws InvalidStyleConfigException if the config is invalid
+         */
+        StyleCompiler(const config::Config *config) : _converter{config}, _config{_converter._config} {}
+        StyleCompiler(const config::CompiledConfig *config) : _converter{config}, _config{config} {}
+        /**
+         * Same definitions and rules numbers as NodesToStyleComponents::convert
+         */
+        std::list<StyleDefinition *> *compile(const std::string &style, int fileNumber, int *ruleNumber);
+        /**
+         * Whether the last compiled style used a construct left to NodesToStyleComponents, and was converted by it instead
+         */
+        bool converted() const { return _converted; }
+    };
+
+} // namespace style
+
+#endif // STYLE_COMPILER_HPP
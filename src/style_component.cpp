@@ -63,26 +63,62 @@ namespace style {
         }
     }
 
+    StyleValue::~StyleValue() {
+        std::vector<StyleValue *> values;
+        StyleValue *value = this;
+        while (true) {
+            if (value->child() != nullptr) values.push_back(value->child());
+            if (value->next() != nullptr) values.push_back(value->next());
+            // unlinked, so the destructor of commons::Node has nothing left to delete
+            value->removeChilds();
+            value->next(nullptr);
+            if (value != this) delete value;
+            if (values.empty()) break;
+            value = values.back();
+            values.pop_back();
+        }
+    }
+
+    StyleValue *StyleValue::copyNexts(const StyleValue *value, StyleValue *parent, std::vector<std::pair<const StyleValue *, StyleValue *>> *copies) {
+        StyleValue *first = nullptr;
+        StyleValue *last = nullptr;
+        for (; value != nullptr; value = value->next()) {
+            StyleValue *newValue = new StyleValue(value->_value, value->_type);
+            newValue->number(value->_number);
+            newValue->parent(parent);
+            if (last == nullptr) first = newValue;
+            else last->next(newValue);
+            last = newValue;
+            copies->emplace_back(value, newValue);
+        }
+        return first;
+    }
+
     StyleValue *StyleValue::copy() const {
-        StyleValue *newValue = new StyleValue(_value, _type);
-        if (child() != nullptr) newValue->addChild(child()->copy());
-        if (next() != nullptr) newValue->next(next()->copy());
+        std::vector<std::pair<const StyleValue *, StyleValue *>> copies;
+        std::pair<const StyleValue *, StyleValue *> copy;
+        StyleValue *newValue = copyNexts(this, nullptr, &copies);
+        while (!copies.empty()) {
+            copy = copies.back();
+            copies.pop_back();
+            if (copy.first->child() != nullptr) copy.second->addChild(copyNexts(copy.first->child(), copy.second, &copies));
+        }
         return newValue;
     }
 
     std::string StyleValue::debugValue() const { return _value + " (" + styleValueTypeToString(_type) + ")"; }
 
-    StyleRule::StyleRule(StyleValue *value, bool enabled, int specificity, int fileNumber, int ruleNumber)
-        : value{value ? value->copy() : nullptr}, enabled{enabled}, specificity{specificity}, fileNumber{fileNumber}, ruleNumber{ruleNumber} {}
+    StyleRule::StyleRule(StyleValue *value, bool enabled, int fileNumber, int ruleNumber)
+        : value{value ? value->copy() : nullptr}, enabled{enabled}, fileNumber{fileNumber}, ruleNumber{ruleNumber} {}
 
     StyleRule::StyleRule(const StyleRule &rule)
-        : value{rule.value ? rule.value->copy() : nullptr}, enabled{rule.enabled}, specificity{rule.specificity}, fileNumber{rule.fileNumber}, ruleNumber{rule.ruleNumber} {}
+        : value{rule.value ? rule.value->copy() : nullptr}, enabled{rule.enabled}, fileNumber{rule.fileNumber}, ruleNumber{rule.ruleNumber} {}
 
     StyleRule &StyleRule::operator=(const StyleRule &rule) {
         if (this != &rule) {
-            if (rule.value) value = rule.value->copy();
+            delete value;
+            value = rule.value ? rule.value->copy() : nullptr;
             enabled = rule.enabled;
-            specificity = rule.specificity;
             fileNumber = rule.fileNumber;
             ruleNumber = rule.ruleNumber;
         }
@@ -90,8 +126,7 @@ namespace style {
         return *this;
     }
 
-    StyleRule::StyleRule(StyleRule &&rule)
-        : value{rule.value}, enabled{rule.enabled}, specificity{rule.specificity}, fileNumber{rule.fileNumber}, ruleNumber{rule.ruleNumber} {
+    StyleRule::StyleRule(StyleRule &&rule) : value{rule.value}, enabled{rule.enabled}, fileNumber{rule.fileNumber}, ruleNumber{rule.ruleNumber} {
         rule.value = nullptr;
         rule.fileNumber = -1;
         rule.ruleNumber = -1;
@@ -99,9 +134,9 @@ namespace style {
 
     StyleRule &StyleRule::operator=(StyleRule &&rule) {
         if (this != &rule) {
+            delete value;
             value = rule.value;
             enabled = rule.enabled;
-            specificity = rule.specificity;
             fileNumber = rule.fileNumber;
             ruleNumber = rule.ruleNumber;
             rule.value = nullptr;
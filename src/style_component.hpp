@@ -2,12 +2,15 @@
 #define STYLE_COMPONENT_HPP
 
 #include "../cpp_commons/src/node.hpp"
+#include "number.hpp"
 #include "tokens.hpp"
 
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace style {
 
@@ -20,6 +23,7 @@ namespace style {
     StyleComponentType tokenTypeToStyleComponentType(Token token);
     StyleValueType tokenTypeToStyleValueType(Token token);
     StyleRelation tokenTypeToStyleRelation(Token token);
+    Token styleValueTypeToTokenType(StyleValueType type);
 
     std::string styleComponentTypeToString(StyleComponentType token);
     std::string styleValueTypeToString(StyleValueType token);
@@ -32,13 +36,41 @@ namespace style {
     class StyleValue : public commons::Node<StyleValue> {
         std::string _value;
         StyleValueType _type;
+        // decoded once when the style is loaded, for Int and Float values
+        Number _number;
+
+        /**
+         * Copy the value and its nexts without their childs, each copy being added with its source to copies
+         */
+        static StyleValue *copyNexts(const StyleValue *value, StyleValue *parent, std::vector<std::pair<const StyleValue *, StyleValue *>> *copies);
 
     public:
         StyleValue(const std::string &value = "", const StyleValueType type = StyleValueType::Null) : _value{value}, _type{type} {};
+        /**
+         * The childs and the nexts are deleted from an explicit stack, so a deep value or a long tuple can't overflow the call stack
+         */
+        ~StyleValue() override;
         void value(const std::string &value) { this->_value = value; }
         void type(StyleValueType type) { this->_type = type; }
+        void number(const Number &number) { this->_number = number; }
         std::string value() const { return _value; }
         StyleValueType type() const { return _type; }
+        /**
+         * Only meaningful for StyleValueType::Int values
+         */
+        int64_t intValue() const { return _number.intValue; }
+        /**
+         * Only meaningful for StyleValueType::Float values
+         */
+        double floatValue() const { return _number.floatValue; }
+        /**
+         * Only meaningful for StyleValueType::Hex values, packed as 0xRRGGBBAA
+         */
+        uint32_t rgbaValue() const { return _number.rgbaValue; }
+        NumberDiagnostic numberDiagnostic() const { return _number.diagnostic; }
+        /**
+         * Copy of the value with its childs and its nexts, made iteratively like the destruction
+         */
         StyleValue *copy() const;
         std::string debugValue() const override;
     };
@@ -46,19 +78,18 @@ namespace style {
     /**
      *   style value
      *   enabled
-     *   specificity
      *   file number
      *   rule number (file dependant)
+     * The specificity is the one of the definition containing the rule
      */
     struct StyleRule {
         StyleValue *value = nullptr;
         bool enabled;
-        int specificity;
         int fileNumber;
         int ruleNumber;
 
-        StyleRule() : value{nullptr}, enabled{false}, specificity{0}, fileNumber{-1}, ruleNumber{-1} {}
-        StyleRule(StyleValue *value, bool enabled, int specificity, int fileNumber, int ruleNumber);
+        StyleRule() : value{nullptr}, enabled{false}, fileNumber{-1}, ruleNumber{-1} {}
+        StyleRule(StyleValue *value, bool enabled, int fileNumber, int ruleNumber);
         // copy constructor
         StyleRule(const StyleRule &rule);
         // copy assignment operator (same as copy constructor, except it's used when using explicitly the assignment operator ('='))
@@ -73,7 +104,22 @@ namespace style {
     typedef std::pair<std::string, StyleComponentType> StyleComponentData;
     typedef std::list<std::pair<StyleComponentData, StyleRelation>> StyleComponentDataList;
     typedef std::unordered_map<std::string, StyleRule> StyleValuesMap;
-    typedef std::pair<StyleComponentDataList, StyleValuesMap> StyleDefinition;
+
+    /**
+     * A selector (first) with the rules of its block (second).
+     * The rules are shared by the definitions of all the selectors of the block (separated by commas) instead of being copied for each one,
+     * and aren't modified once shared, the specificity of the selector being stored beside them.
+     */
+    struct StyleDefinition {
+        StyleComponentDataList first;
+        std::shared_ptr<const StyleValuesMap> second;
+        int specificity;
+
+        StyleDefinition(const StyleComponentDataList &components, const StyleValuesMap &rules, int specificity = 0)
+            : first{components}, second{std::make_shared<StyleValuesMap>(rules)}, specificity{specificity} {}
+        StyleDefinition(StyleComponentDataList &&components, std::shared_ptr<const StyleValuesMap> rules, int specificity)
+            : first{std::move(components)}, second{std::move(rules)}, specificity{specificity} {}
+    };
 
     typedef std::unordered_map<std::string, StyleRule> RulesMap; // XXX: same as StyleValuesMap
 
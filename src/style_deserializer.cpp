@@ -1,26 +1,88 @@
 #include "style_deserializer.hpp"
 #include "nodes_to_style_components.hpp"
+#include "style_compiler.hpp"
 #include <fstream>
-#include <sstream>
+#include <iostream>
 
 namespace style {
 
     std::list<StyleDefinition *> *StyleDeserializer::deserializeFromFile(const std::string &fileName, int fileNumber, int *ruleNumber,
-                                                                         const config::Config *config) {
+                                                                         const config::CompiledConfig *config) {
         std::ifstream file(fileName);
-        std::stringstream buffer;
         if (!file.is_open()) {
             std::cerr << "File '" << fileName << "' couldn't be opened\n";
             return nullptr;
         }
-        buffer << file.rdbuf();
 
-        return deserialize(buffer.str(), fileNumber, ruleNumber, config);
+        return deserialize(file, fileNumber, ruleNumber, config);
     }
 
     std::list<StyleDefinition *> *StyleDeserializer::deserialize(const std::string &style, int fileNumber, int *ruleNumber,
-                                                                 const config::Config *config) {
+                                                                 const config::CompiledConfig *config) {
+        return NodesToStyleComponents(config).convert(style, fileNumber, ruleNumber);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserialize(std::istream &style, int fileNumber, int *ruleNumber,
+                                                                 const config::CompiledConfig *config) {
         return NodesToStyleComponents(config).convert(style, fileNumber, ruleNumber);
     }
 
+    std::list<StyleDefinition *> *StyleDeserializer::deserialize(const FlatTree &style, int fileNumber, int *ruleNumber,
+                                                                 const config::CompiledConfig *config) {
+        return NodesToStyleComponents(config).convert(style, fileNumber, ruleNumber);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::compile(const std::string &style, int fileNumber, int *ruleNumber,
+                                                             const config::CompiledConfig *config) {
+        return StyleCompiler(config).compile(style, fileNumber, ruleNumber);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserializeInParallel(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                           const config::CompiledConfig *config, unsigned int threadsCount) {
+        return NodesToStyleComponents(config).convertInParallel(style, fileNumber, ruleNumber, threadsCount);
+    }
+
+    // the overloads taking a config compile it once and use the ones taking a compiled config
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserializeFromFile(const std::string &fileName, int fileNumber, int *ruleNumber,
+                                                                         const config::Config *config) {
+        config::CompiledConfig compiledConfig(config);
+        return deserializeFromFile(fileName, fileNumber, ruleNumber, &compiledConfig);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserialize(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                 const config::Config *config) {
+        config::CompiledConfig compiledConfig(config);
+        return deserialize(style, fileNumber, ruleNumber, &compiledConfig);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserialize(std::istream &style, int fileNumber, int *ruleNumber,
+                                                                 const config::Config *config) {
+        config::CompiledConfig compiledConfig(config);
+        return deserialize(style, fileNumber, ruleNumber, &compiledConfig);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserialize(const FlatTree &style, int fileNumber, int *ruleNumber,
+                                                                 const config::Config *config) {
+        config::CompiledConfig compiledConfig(config);
+        return deserialize(style, fileNumber, ruleNumber, &compiledConfig);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::compile(const std::string &style, int fileNumber, int *ruleNumber,
+                                                             const config::Config *config) {
+        config::CompiledConfig compiledConfig(config);
+        return compile(style, fileNumber, ruleNumber, &compiledConfig);
+    }
+
+    std::list<StyleDefinition *> *StyleDeserializer::deserializeInParallel(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                           const config::Config *config, unsigned int threadsCount) {
+        config::CompiledConfig compiledConfig(config);
+        return deserializeInParallel(style, fileNumber, ruleNumber, &compiledConfig, threadsCount);
+    }
+
+    std::list<IndexedStyleDefinition *> *StyleDeserializer::deserializeIndexed(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                                const config::CompiledConfig *config) {
+        return indexStyleDefinitions(compile(style, fileNumber, ruleNumber, config), config);
+    }
+
 } // namespace style
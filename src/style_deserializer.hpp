@@ -2,7 +2,11 @@
 #define STYLE_DESERIALIZER_HPP
 
 #include "abstract_configuration.hpp"
+#include "compiled_config.hpp"
+#include "flat_tree.hpp"
+#include "indexed_rules.hpp"
 #include "style_component.hpp"
+#include <istream>
 #include <list>
 #include <string>
 
@@ -13,6 +17,40 @@ namespace style {
         static std::list<StyleDefinition *> *deserializeFromFile(const std::string &fileName, int fileNumber, int *ruleNumber,
                                                             const config::Config *config);
         static std::list<StyleDefinition *> *deserialize(const std::string &style, int fileNumber, int *ruleNumber, const config::Config *config);
+        /**
+         * The style is read and lexed by chunks, so it is never entirely in memory
+         */
+        static std::list<StyleDefinition *> *deserialize(std::istream &style, int fileNumber, int *ruleNumber, const config::Config *config);
+        /**
+         * For a style already parsed by Parser::parseFlat
+         */
+        static std::list<StyleDefinition *> *deserialize(const FlatTree &style, int fileNumber, int *ruleNumber, const config::Config *config);
+        /**
+         * Single pass compilation of the style (see StyleCompiler), giving the same definitions as deserialize
+         */
+        static std::list<StyleDefinition *> *compile(const std::string &style, int fileNumber, int *ruleNumber, const config::Config *config);
+        /**
+         * For large styles made of many blocks, which are lexed and parsed on threadsCount threads (0 for as many as the processor can run)
+         */
+        static std::list<StyleDefinition *> *deserializeInParallel(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                   const config::Config *config, unsigned int threadsCount = 0);
+
+        // same functions with a config compiled once for all the styles deserialized with it, which isn't validated again
+        static std::list<StyleDefinition *> *deserializeFromFile(const std::string &fileName, int fileNumber, int *ruleNumber,
+                                                            const config::CompiledConfig *config);
+        static std::list<StyleDefinition *> *deserialize(const std::string &style, int fileNumber, int *ruleNumber,
+                                                         const config::CompiledConfig *config);
+        static std::list<StyleDefinition *> *deserialize(std::istream &style, int fileNumber, int *ruleNumber, const config::CompiledConfig *config);
+        static std::list<StyleDefinition *> *deserialize(const FlatTree &style, int fileNumber, int *ruleNumber,
+                                                         const config::CompiledConfig *config);
+        static std::list<StyleDefinition *> *compile(const std::string &style, int fileNumber, int *ruleNumber, const config::CompiledConfig *config);
+        static std::list<StyleDefinition *> *deserializeInParallel(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                   const config::CompiledConfig *config, unsigned int threadsCount = 0);
+        /**
+         * Same definitions as compile, with the rules of each block indexed by the ids of their names in the config (see IndexedRules)
+         */
+        static std::list<IndexedStyleDefinition *> *deserializeIndexed(const std::string &style, int fileNumber, int *ruleNumber,
+                                                                       const config::CompiledConfig *config);
     };
 
 } // namespace Style
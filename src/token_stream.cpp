@@ -0,0 +1,112 @@
+#include "token_stream.hpp"
+
+namespace style {
+
+    void decodeNumber(LexedToken *token, std::string_view value) {
+        if (token->token == Token::Int) token->number = decodeInt(value);
+        else if (token->token == Token::Float) token->number = decodeFloat(value);
+    }
+
+    void TokenStream::push(Token token, size_t start, size_t length, uint8_t flags) {
+        LexedToken lexedToken = LexedToken{token, static_cast<uint32_t>(start), static_cast<uint32_t>(length), flags, Number{}};
+        decodeNumber(&lexedToken, value(lexedToken));
+        _tokens.push_back(lexedToken);
+    }
+
+    TokenStream TokenStream::owningValues() {
+        TokenStream stream;
+        stream._values = std::make_shared<std::string>();
+        return stream;
+    }
+
+    size_t TokenStream::appendValue(std::string_view value) {
+        size_t start = _values->size();
+        // appending to values shared with a copy of the stream would reallocate them under it
+        if (_values.use_count() > 1) {
+            std::shared_ptr<std::string> values = std::make_shared<std::string>();
+            values->reserve(start + value.size());
+            values->append(*_values);
+            _values = values;
+        }
+        _values->append(value);
+        // the values can have been reallocated
+        _expression = *_values;
+        return start;
+    }
+
+    void TokenStream::pushValue(Token token, std::string_view value, uint8_t flags) {
+        size_t start = appendValue(value);
+        push(token, start, value.size(), flags);
+    }
+
+    void TokenStream::pushValue(const LexedToken &token, std::string_view value) {
+        LexedToken ownedToken = token;
+        ownedToken.start = appendValue(value);
+        _tokens.push_back(ownedToken);
+    }
+
+    void TokenStream::resetOwningValues() {
+        _tokens.clear();
+        // the values can be shared with a copy of the stream
+        if (_values == nullptr || _values.use_count() > 1) _values = std::make_shared<std::string>();
+        else _values->clear();
+        _expression = *_values;
+    }
+
+    void TokenStream::discard(size_t count) {
+        _tokens.erase(_tokens.begin(), _tokens.begin() + count);
+        if (_values == nullptr) return;
+        size_t start = _tokens.empty() ? _values->size() : _tokens.front().start;
+        if (_values.use_count() > 1) _values = std::make_shared<std::string>(_values->substr(start));
+        else _values->erase(0, start);
+        for (LexedToken &token : _tokens) {
+            token.start -= start;
+        }
+        _expression = *_values;
+    }
+
+    DeserializationNode *TokenStream::toNodes(bool borrowValues) const {
+        DeserializationNode *firstNode = new DeserializationNode(Token::NullRoot);
+        DeserializationNode *lastNode = firstNode;
+        DeserializationNode *node;
+        for (const LexedToken &token : _tokens) {
+            if (token.flags) {
+                node = new DeserializationNode((token.flags & PRECEDED_BY_LINE_BREAK) ? Token::LineBreak : Token::Space);
+                lastNode->next(node);
+                lastNode = node;
+            }
+            node = new DeserializationNode(token.token);
+            if (token.length) {
+                if (borrowValues) node->borrowValue(value(token));
+                else node->value(value(token));
+            }
+            node->number(token.number);
+            lastNode->next(node);
+            lastNode = node;
+        }
+        // remove the NullRoot token at the start
+        node = firstNode->next();
+        firstNode->next(nullptr);
+        delete firstNode;
+        return node;
+    }
+
+    TokenStream TokenStream::fromNodes(const DeserializationNode *nodes, std::string *buffer) {
+        const DeserializationNode *node = nodes;
+        buffer->clear();
+        while (node != nullptr) {
+            buffer->append(node->value());
+            node = node->next();
+        }
+        TokenStream stream = TokenStream(*buffer);
+        size_t start = 0;
+        node = nodes;
+        while (node != nullptr) {
+            stream.push(node->token(), start, node->value().size());
+            start += node->value().size();
+            node = node->next();
+        }
+        return stream;
+    }
+
+} // namespace style
@@ -0,0 +1,111 @@
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "deserialization_node.hpp"
+#include "number.hpp"
+#include "tokens.hpp"
+
+namespace style {
+
+    // bits of LexedToken::flags, set when the lexer doesn't add white space tokens
+    constexpr uint8_t PRECEDED_BY_SPACE = 1;
+    constexpr uint8_t PRECEDED_BY_LINE_BREAK = 2;
+
+    /**
+     * Compact token produced by the lexer.
+     * The value is not stored, it is the span [start, start + length[ of the lexed expression.
+     */
+    struct LexedToken {
+        Token token;
+        uint32_t start;
+        uint32_t length;
+        // white spaces between the previous token and this one (PRECEDED_BY_SPACE, PRECEDED_BY_LINE_BREAK)
+        uint8_t flags;
+        // preparsed value, only meaningful for Int (intValue) and Float (floatValue) tokens
+        Number number;
+    };
+
+    /**
+     * Decode the value of an Int or Float token in its number payload.
+     * Other tokens are left untouched.
+     */
+    void decodeNumber(LexedToken *token, std::string_view value);
+
+    /**
+     * Contiguous list of tokens referencing the expression they were lexed from.
+     * The expression must outlive the stream, unless the stream owns its values (see owningValues).
+     */
+    class TokenStream {
+        std::string_view _expression;
+        std::vector<LexedToken> _tokens;
+        // concatenated values of the tokens when the stream doesn't reference an external expression, shared by the copies of the stream
+        std::shared_ptr<std::string> _values;
+
+        // append the value to the owned values, copied first if they are shared with a copy of the stream, and return its start
+        size_t appendValue(std::string_view value);
+
+    public:
+        TokenStream(std::string_view expression = "") : _expression{expression} {}
+        /**
+         * Stream whose tokens are added with pushValue, storing only their values instead of the whole expression
+         */
+        static TokenStream owningValues();
+        std::string_view expression() const { return _expression; }
+        std::string_view value(const LexedToken &token) const { return _expression.substr(token.start, token.length); }
+        void push(Token token, size_t start = 0, size_t length = 0, uint8_t flags = 0);
+        /**
+         * Copy the value at the end of the owned values, only for streams created with owningValues
+         */
+        void pushValue(Token token, std::string_view value, uint8_t flags = 0);
+        // same as pushValue for a token lexed from an other expression, keeping its flags and its decoded number
+        void pushValue(const LexedToken &token, std::string_view value);
+        // add a token already lexed from the same expression
+        void push(const LexedToken &token) { _tokens.push_back(token); }
+        void clear() { _tokens.clear(); }
+        /**
+         * Remove the tokens to reference an other expression, keeping the memory allocated for them
+         */
+        void reset(std::string_view expression) {
+            _expression = expression;
+            _tokens.clear();
+            _values.reset();
+        }
+        /**
+         * Remove the tokens to own the values of the next ones like a stream created with owningValues, keeping the memory allocated for them
+         */
+        void resetOwningValues();
+        /**
+         * Remove the count first tokens.
+         * When the stream owns its values, the values of the removed tokens are removed too.
+         */
+        void discard(size_t count);
+        const LexedToken &back() const { return _tokens.back(); }
+        const LexedToken &operator[](size_t index) const { return _tokens[index]; }
+        size_t size() const { return _tokens.size(); }
+        bool empty() const { return _tokens.empty(); }
+        std::vector<LexedToken>::const_iterator begin() const { return _tokens.cbegin(); }
+        std::vector<LexedToken>::const_iterator end() const { return _tokens.cend(); }
+
+        /**
+         * Build a chain of nodes like the one Lexer::lexe returns.
+         * If borrowValues is true, the nodes reference the expression instead of owning a copy of their value.
+         * The white spaces flags are added back as Space or LineBreak nodes.
+         */
+        DeserializationNode *toNodes(bool borrowValues) const;
+
+        /**
+         * Build a stream from a chain of nodes.
+         * The values are concatenated in buffer, which is the expression of the returned stream.
+         */
+        static TokenStream fromNodes(const DeserializationNode *nodes, std::string *buffer);
+    };
+
+} // namespace style
+
+#endif // TOKEN_STREAM_HPP
@@ -0,0 +1,46 @@
+#include "unit_matcher.hpp"
+
+namespace style {
+
+    UnitMatcher::UnitMatcher(const std::vector<std::string> &units) {
+        _characterIndexes.fill(0);
+        for (const std::string &unit : units) {
+            for (char c : unit) {
+                if (!characterIndex(c)) _characterIndexes[static_cast<unsigned char>(c)] = _alphabetSize++;
+            }
+        }
+
+        _transitions.assign(_alphabetSize, 0);
+        _unitEnds.push_back(false);
+        for (const std::string &unit : units) {
+            if (unit.empty()) continue;
+            uint32_t node = 0;
+            for (char c : unit) {
+                uint32_t &next = _transitions[node * _alphabetSize + characterIndex(c)];
+                if (!next) {
+                    next = _unitEnds.size();
+                    _unitEnds.push_back(false);
+                    // may reallocate, so next isn't used after this
+                    _transitions.resize(_transitions.size() + _alphabetSize, 0);
+                }
+                node = _transitions[node * _alphabetSize + characterIndex(c)];
+            }
+            _unitEnds[node] = true;
+            if (unit.size() > _maxUnitSize) _maxUnitSize = unit.size();
+        }
+    }
+
+    size_t UnitMatcher::match(std::string_view text, size_t start) const {
+        uint32_t node = 0;
+        size_t longestUnitSize = 0;
+        for (size_t i = start; i < text.size(); i++) {
+            uint16_t index = characterIndex(text[i]);
+            if (!index) break;
+            node = _transitions[node * _alphabetSize + index];
+            if (!node) break;
+            if (_unitEnds[node]) longestUnitSize = i - start + 1;
+        }
+        return longestUnitSize;
+    }
+
+} // namespace style
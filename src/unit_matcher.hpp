@@ -0,0 +1,40 @@
+#ifndef UNIT_MATCHER_HPP
+#define UNIT_MATCHER_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace style {
+
+    /**
+     * Trie of the units of a config, finding the longest unit at a position in O(length of the unit),
+     * whatever the number of units.
+     */
+    class UnitMatcher {
+        // index of each character in the characters used by the units, 0 if unused
+        std::array<uint16_t, 256> _characterIndexes;
+        size_t _alphabetSize = 1;
+        // _transitions[node * _alphabetSize + characterIndex] is the next node, 0 if none (the root is never a next node)
+        std::vector<uint32_t> _transitions;
+        // whether the path from the root to the node is a unit
+        std::vector<bool> _unitEnds;
+        size_t _maxUnitSize = 0;
+
+        uint16_t characterIndex(char c) const { return _characterIndexes[static_cast<unsigned char>(c)]; }
+
+    public:
+        UnitMatcher(const std::vector<std::string> &units = {});
+        /**
+         * Size of the longest unit starting at text[start], 0 if there is none
+         */
+        size_t match(std::string_view text, size_t start) const;
+        bool canStartUnit(char c) const { return characterIndex(c) && _transitions[characterIndex(c)]; }
+        size_t maxUnitSize() const { return _maxUnitSize; }
+    };
+
+} // namespace style
+
+#endif // UNIT_MATCHER_HPP
@@ -131,6 +131,86 @@ namespace configTests {
         return result;
     }
 
+    bool valueMatches(const style::config::RuleMatcher &matcher, const std::vector<std::pair<style::Token, std::string_view>> &nodes) {
+        style::config::RuleMatcher::Match match;
+        match.start(&matcher);
+        for (const std::pair<style::Token, std::string_view> &node : nodes) {
+            if (node.first == style::Token::NullRoot) match.close();
+            else match.open(node.first, node.second);
+        }
+        return match.matched();
+    }
+
+    test::Result testCompiledConfigLookups() {
+        style::config::ConfigRuleNode *alignment = new style::config::ConfigRuleNodeEnum({"left", "right"});
+        style::config::ConfigRuleNode *padding = new style::config::ConfigRuleNode(style::Token::Int);
+        const style::config::Config *config = new style::config::Config{{{"padding", {padding}}, {"alignment", {alignment}}}, {"px"}};
+        const style::config::CompiledConfig compiledConfig(config);
+        test::Result result = test::Result::SUCCESS;
+        // the rules are numbered in the order of their names
+        if (compiledConfig.rulesCount() != 2 || compiledConfig.ruleId("alignment") != 0 || compiledConfig.ruleId("padding") != 1 ||
+            compiledConfig.ruleName(1) != "padding" || compiledConfig.ruleNodes(0).front() != alignment) {
+            result = test::Result::FAILURE;
+        }
+        if (compiledConfig.ruleId("margin") != style::config::CompiledConfig::NO_RULE) result = test::Result::FAILURE;
+        if (!valueMatches(compiledConfig.ruleMatcher(0), {{style::Token::EnumValue, "right"}, {style::Token::NullRoot, ""}}) ||
+            valueMatches(compiledConfig.ruleMatcher(0), {{style::Token::EnumValue, "center"}, {style::Token::NullRoot, ""}})) {
+            result = test::Result::FAILURE;
+        }
+        if (compiledConfig.units().maxUnitSize() != 2) result = test::Result::FAILURE;
+        delete config;
+        return result;
+    }
+
+    test::Result testRuleMatcher() {
+        using style::Token;
+        const Token CLOSE = Token::NullRoot;
+        std::vector<const style::config::ConfigRuleNode *> alternatives = {
+            new style::config::ConfigRuleNode(Token::Tuple,
+                                              new style::config::ConfigRuleNode(Token::Int, nullptr, new style::config::ConfigRuleNode(Token::Int))),
+            new style::config::ConfigRuleNode(
+                Token::Tuple,
+                new style::config::ConfigRuleNode(Token::Int, nullptr,
+                                                  new style::config::ConfigRuleNode(Token::Unit, new style::config::ConfigRuleNode(Token::Int)))),
+            new style::config::ConfigRuleNode(Token::Int), new style::config::ConfigRuleNode(Token::Function)};
+        const style::config::RuleMatcher matcher(alternatives);
+        test::Result result = test::Result::SUCCESS;
+        // the childs are matched with the ones of the config, a function without childs in the config accepting any arguments
+        if (!valueMatches(matcher, {{Token::Tuple, ""}, {Token::Int, "1"}, {CLOSE, ""}, {Token::Int, "2"}, {CLOSE, ""}, {CLOSE, ""}}) ||
+            !valueMatches(matcher, {{Token::Tuple, ""}, {Token::Int, "1"}, {CLOSE, ""}, {Token::Unit, "px"}, {Token::Int, "2"}, {CLOSE, ""},
+                                    {CLOSE, ""}, {CLOSE, ""}}) ||
+            !valueMatches(matcher, {{Token::Int, "3"}, {CLOSE, ""}}) ||
+            !valueMatches(matcher, {{Token::Function, "f"}, {Token::Tuple, ""}, {Token::String, "a"}, {CLOSE, ""}, {CLOSE, ""}, {CLOSE, ""}})) {
+            result = test::Result::FAILURE;
+        }
+        if (valueMatches(matcher, {{Token::Tuple, ""}, {Token::Int, "1"}, {CLOSE, ""}, {CLOSE, ""}}) ||
+            valueMatches(matcher, {{Token::Tuple, ""}, {Token::Int, "1"}, {CLOSE, ""}, {Token::Unit, "px"}, {Token::Float, "2.5"}, {CLOSE, ""},
+                                   {CLOSE, ""}, {CLOSE, ""}}) ||
+            valueMatches(matcher, {{Token::Tuple, ""}, {Token::Int, "1"}, {CLOSE, ""}, {Token::Int, "2"}, {CLOSE, ""}, {Token::Int, "3"},
+                                   {CLOSE, ""}, {CLOSE, ""}}) ||
+            valueMatches(matcher, {}) || valueMatches(matcher, {{Token::Float, "3.5"}, {CLOSE, ""}})) {
+            result = test::Result::FAILURE;
+        }
+        for (const style::config::ConfigRuleNode *alternative : alternatives) {
+            delete alternative;
+        }
+        return result;
+    }
+
+    test::Result testCompiledInvalidConfig() {
+        style::config::ConfigRuleNode *node = new style::config::ConfigRuleNode(style::Token::Int);
+        const style::config::Config *config = new style::config::Config{{{"an invalid rule", {node}}}, {}};
+        test::Result result = test::Result::FAILURE;
+        try {
+            style::config::CompiledConfig compiledConfig(config);
+        }
+        catch (const style::config::InvalidStyleConfigException &) {
+            result = test::Result::SUCCESS;
+        }
+        delete config;
+        return result;
+    }
+
     void configTests(test::Tests *tests) {
         tests->beginTestBlock("Config tests");
         tests->addTest(testInvalidRuleNameWithSpaces, "Invalid rule name with spaces");
@@ -144,6 +224,9 @@ namespace configTests {
         tests->addTest(testRuleWithFunctionTokenWithChilds, "Rule with function token with childs");
         tests->addTest(testRuleWithTupleTokenWithChilds, "Rule with tuple token with childs");
         tests->addTest(testRuleWithNonNestableTokenWithChilds, "Rule with non nestable token with childs");
+        tests->addTest(testCompiledConfigLookups, "Compiled config lookups");
+        tests->addTest(testCompiledInvalidConfig, "Compiled invalid config");
+        tests->addTest(testRuleMatcher, "Rule matcher");
         tests->endTestBlock();
     }
 
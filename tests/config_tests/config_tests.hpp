@@ -3,6 +3,7 @@
 
 #include "../../cpp_tests/src/tests.hpp"
 #include "../../src/abstract_configuration.hpp"
+#include "../../src/compiled_config.hpp"
 
 namespace configTests {
     template <typename T>
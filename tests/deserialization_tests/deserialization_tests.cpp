@@ -84,10 +84,6 @@ namespace deserializationTests {
             std::cerr << "The rule number is different (have '" << testedRule->ruleNumber << "', expected '" << expectedRule->ruleNumber << "')\n";
             return test::Result::FAILURE;
         }
-        if (testedRule->specificity != expectedRule->specificity) {
-            std::cerr << "The specificity is different (have '" << testedRule->specificity << "', expected '" << expectedRule->specificity << "')\n";
-            return test::Result::FAILURE;
-        }
         if (testedRule->enabled != expectedRule->enabled) {
             std::cerr << "The enabled status is different (have '" << testedRule->enabled << "', expected '" << expectedRule->enabled << "')\n";
             return test::Result::FAILURE;
@@ -139,8 +135,17 @@ namespace deserializationTests {
             while (testedStyleDefinitionsIt != testedStyleDefinitions->cend()) {
                 result = checkStyleComponentDataList(&(*testedStyleDefinitionsIt)->first, &(*expectedStyleDefinitionsIt)->first);
                 if (result != test::Result::SUCCESS) return result;
-                result = checkStyleMap(&(*testedStyleDefinitionsIt)->second, &(*expectedStyleDefinitionsIt)->second);
+                result = checkStyleMap((*testedStyleDefinitionsIt)->second.get(), (*expectedStyleDefinitionsIt)->second.get());
                 if (result != test::Result::SUCCESS) return result;
+                if ((*testedStyleDefinitionsIt)->specificity != (*expectedStyleDefinitionsIt)->specificity) {
+                    std::cerr
+                        << "The specificity is different (have '"
+                        << (*testedStyleDefinitionsIt)->specificity
+                        << "', expected '"
+                        << (*expectedStyleDefinitionsIt)->specificity
+                        << "')\n";
+                    return test::Result::FAILURE;
+                }
                 testedStyleDefinitionsIt++;
                 expectedStyleDefinitionsIt++;
             }
@@ -184,6 +189,29 @@ namespace deserializationTests {
         return result;
     }
 
+    // same as testDeserialization, with the style also deserialized from a flat tree and compiled, which join the nested blocks on their own
+    test::Result testNestedBlocksDeserialization(const std::string &style, const std::list<style::StyleDefinition *> *expectedStyleDefinitions) {
+        int fileNumber = 0;
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        test::Result result = testDeserialization(style, expectedStyleDefinitions);
+
+        for (int i = 0; i < 2 && result == test::Result::SUCCESS; i++) {
+            if (i == 0)
+                styleDefinitions = style::StyleDeserializer::deserialize(style::Parser().parseFlat(style, config), fileNumber, &ruleNumber, config);
+            else styleDefinitions = style::StyleDeserializer::compile(style, fileNumber, &ruleNumber, config);
+            result = checkStyleDefinitions(styleDefinitions, expectedStyleDefinitions);
+
+            for (style::StyleDefinition *component : *styleDefinitions) {
+                delete component;
+            }
+            delete styleDefinitions;
+        }
+        delete config;
+        return result;
+    }
+
     template <typename T>
     test::Result checkDeserializationError(const std::string &style) {
         int fileNumber = 0;
@@ -228,8 +256,8 @@ namespace deserializationTests {
         expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
         expectedData.push_back(std::pair(std::pair("red", style::StyleComponentType::Identifier), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("ff0000", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 111, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 111);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(".container      label#red{text-color : #ff0000;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -250,8 +278,8 @@ namespace deserializationTests {
         expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
         expectedData.push_back(std::pair(std::pair("red", style::StyleComponentType::Identifier), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("ff0000", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 111, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 111);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(".container > label#red{text-color : #ff0000;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -272,8 +300,8 @@ namespace deserializationTests {
         expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
         expectedData.push_back(std::pair(std::pair("red", style::StyleComponentType::Identifier), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("ff0000", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 111, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 111);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(".container>label#red{text-color : #ff0000;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -294,8 +322,8 @@ namespace deserializationTests {
         styleValue = new style::StyleValue("px", style::StyleValueType::Unit);
         style::StyleValue *styleValue2 = new style::StyleValue("100", style::StyleValueType::Int);
         styleValue->addChild(styleValue2);
-        expectedStyleMap.insert_or_assign("padding", style::StyleRule{styleValue, true, 1, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("padding", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 1);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization("label {padding:100px;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -316,8 +344,8 @@ namespace deserializationTests {
         styleValue = new style::StyleValue("px", style::StyleValueType::Unit);
         style::StyleValue *styleValue2 = new style::StyleValue("100", style::StyleValueType::Int);
         styleValue->addChild(styleValue2);
-        expectedStyleMap.insert_or_assign("padding", style::StyleRule{styleValue, true, 10, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("padding", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 10);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(":hovered {padding:100px;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -360,8 +388,8 @@ namespace deserializationTests {
 
         expectedData.push_back(std::pair(std::pair("a", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("aaaaaa", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 1, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 1);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization("a {text-color: #aaaaaa;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -380,8 +408,8 @@ namespace deserializationTests {
 
         expectedData.push_back(std::pair(std::pair("a", style::StyleComponentType::Class), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("aaaaaa", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 10, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 10);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(".a {text-color: #aaaaaa;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -400,8 +428,8 @@ namespace deserializationTests {
 
         expectedData.push_back(std::pair(std::pair("a", style::StyleComponentType::Modifier), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("aaaaaa", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 10, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 10);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization(":a {text-color: #aaaaaa;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -420,8 +448,8 @@ namespace deserializationTests {
 
         expectedData.push_back(std::pair(std::pair("a", style::StyleComponentType::Identifier), style::StyleRelation::SameElement));
         styleValue = new style::StyleValue("aaaaaa", style::StyleValueType::Hex);
-        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 100, 0, 0});
-        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap);
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{styleValue, true, 0, 0});
+        styleDefinition = new style::StyleDefinition(expectedData, expectedStyleMap, 100);
         expectedStyleDefinitions = {styleDefinition};
         result = testDeserialization("#a {text-color: #aaaaaa;}", &expectedStyleDefinitions);
         delete styleDefinition;
@@ -430,6 +458,706 @@ namespace deserializationTests {
         return result;
     }
 
+    test::Result testDecodedNumber() {
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        test::Result result = test::Result::FAILURE;
+        const std::string style = "label {padding: 12px;}";
+        std::cout << "Tested style:\n" << style << "\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+        if (styleDefinitions->size() == 1) {
+            const style::StyleValuesMap &styleMap = *styleDefinitions->front()->second;
+            style::StyleValuesMap::const_iterator padding = styleMap.find("padding");
+            if (padding != styleMap.cend() && padding->second.value != nullptr) {
+                const style::StyleValue *number = padding->second.value->child();
+                if (number != nullptr
+                    && number->type() == style::StyleValueType::Int
+                    && number->intValue() == 12
+                    && number->numberDiagnostic() == style::NumberDiagnostic::None)
+                    result = test::Result::SUCCESS;
+            }
+        }
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testDecodedHexColor() {
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        test::Result result = test::Result::FAILURE;
+        const std::string style = "label {text-color: #ff000080;}";
+        std::cout << "Tested style:\n" << style << "\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 0, &ruleNumber, config);
+        if (styleDefinitions->size() == 1) {
+            const style::StyleValuesMap &styleMap = *styleDefinitions->front()->second;
+            style::StyleValuesMap::const_iterator textColor = styleMap.find("text-color");
+            if (textColor != styleMap.cend()
+                && textColor->second.value != nullptr
+                && textColor->second.value->type() == style::StyleValueType::Hex
+                && textColor->second.value->rgbaValue() == 0xff000080)
+                result = test::Result::SUCCESS;
+        }
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testNestedBlockInSeveralSelectors() {
+        style::StyleComponentDataList expectedData = style::StyleComponentDataList();
+        style::StyleValuesMap expectedStyleMap = style::StyleValuesMap();
+        std::list<style::StyleDefinition *> expectedStyleDefinitions;
+        test::Result result;
+
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{new style::StyleValue("ff0000", style::StyleValueType::Hex), true, 0, 0});
+        expectedData.push_back(std::pair(std::pair("window", style::StyleComponentType::ElementName), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 2));
+        expectedData.clear();
+        expectedData.push_back(std::pair(std::pair("main", style::StyleComponentType::Class), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 11));
+        // the nested block is joined to each selector of its parent block, not only to the first one
+        result = testNestedBlocksDeserialization("window, .main {\n    label {text-color: #ff0000;}\n}\n", &expectedStyleDefinitions);
+        for (style::StyleDefinition *styleDefinition : expectedStyleDefinitions) {
+            delete styleDefinition;
+        }
+        return result;
+    }
+
+    test::Result testNestedBlockWithSeveralSelectors() {
+        style::StyleComponentDataList expectedData = style::StyleComponentDataList();
+        style::StyleValuesMap expectedStyleMap = style::StyleValuesMap();
+        std::list<style::StyleDefinition *> expectedStyleDefinitions;
+        test::Result result;
+
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{new style::StyleValue("ff0000", style::StyleValueType::Hex), true, 0, 0});
+        expectedData.push_back(std::pair(std::pair("window", style::StyleComponentType::ElementName), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("icon", style::StyleComponentType::Class), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 11));
+        expectedData.clear();
+        expectedData.push_back(std::pair(std::pair("window", style::StyleComponentType::ElementName), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("", style::StyleComponentType::StarWildcard), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 1));
+        // each selector of the nested block is joined to the parent selector, not only the first one
+        result = testNestedBlocksDeserialization("window {\n    .icon, * {text-color: #ff0000;}\n}\n", &expectedStyleDefinitions);
+        for (style::StyleDefinition *styleDefinition : expectedStyleDefinitions) {
+            delete styleDefinition;
+        }
+        return result;
+    }
+
+    test::Result testSameElementWithSeveralParentSelectors() {
+        style::StyleComponentDataList expectedData = style::StyleComponentDataList();
+        style::StyleValuesMap expectedStyleMap = style::StyleValuesMap();
+        std::list<style::StyleDefinition *> expectedStyleDefinitions;
+        test::Result result;
+
+        expectedStyleMap.insert_or_assign("text-color", style::StyleRule{new style::StyleValue("ff0000", style::StyleValueType::Hex), true, 0, 0});
+        expectedData.push_back(std::pair(std::pair("window", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
+        expectedData.push_back(std::pair(std::pair("hover", style::StyleComponentType::Modifier), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 11));
+        expectedData.clear();
+        expectedData.push_back(std::pair(std::pair("window", style::StyleComponentType::ElementName), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 2));
+        expectedData.clear();
+        expectedData.push_back(std::pair(std::pair("main", style::StyleComponentType::Class), style::StyleRelation::SameElement));
+        expectedData.push_back(std::pair(std::pair("hover", style::StyleComponentType::Modifier), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 20));
+        expectedData.clear();
+        expectedData.push_back(std::pair(std::pair("main", style::StyleComponentType::Class), style::StyleRelation::AnyParent));
+        expectedData.push_back(std::pair(std::pair("label", style::StyleComponentType::ElementName), style::StyleRelation::SameElement));
+        expectedStyleDefinitions.push_back(new style::StyleDefinition(expectedData, expectedStyleMap, 11));
+        // the '&' is joined to each parent selector, and doesn't change the relation of the other selectors of the nested block
+        result = testNestedBlocksDeserialization("window, .main {\n    &:hover, label {text-color: #ff0000;}\n}\n", &expectedStyleDefinitions);
+        for (style::StyleDefinition *styleDefinition : expectedStyleDefinitions) {
+            delete styleDefinition;
+        }
+        return result;
+    }
+
+    test::Result testParallelDeserialization() {
+        int ruleNumber;
+        int parallelRuleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *> *parallelStyleDefinitions;
+        test::Result result;
+        std::string style;
+        // enough blocks to be split in many chunks, with curly brackets in comments and nested blocks
+        for (int i = 0; i < 2000; i++) {
+            style += ".block" + std::to_string(i) + " label {\n    padding: " + std::to_string(i % 100) + "px; // }\n";
+            if (i % 3 == 0) style += "    #nested {text-color: #" + std::to_string(100000 + i % 900000) + ";}\n";
+            style += "}\n/* { */\n";
+        }
+        std::cout << "Tested style: " << style.size() << " characters deserialized serially and in parallel\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+        parallelStyleDefinitions = style::StyleDeserializer::deserializeInParallel(style, 1, &parallelRuleNumber, config, 4);
+        result = checkStyleDefinitions(parallelStyleDefinitions, styleDefinitions);
+        if (result == test::Result::SUCCESS && parallelRuleNumber != ruleNumber) result = test::Result::FAILURE;
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        for (style::StyleDefinition *component : *parallelStyleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete parallelStyleDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testFlatTreeDeserialization() {
+        int ruleNumber;
+        int flatRuleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *> *flatStyleDefinitions;
+        test::Result result;
+        // nested blocks, an & joined to many parent selectors, an invalid rule and a block with only invalid rules
+        const std::string style = "window, .main label {\n"
+                                  "    padding: 3px;\n"
+                                  "    unknown-rule: 2;\n"
+                                  "    &:hover, button {\n"
+                                  "        text-color: #ff0000;\n"
+                                  "        > .icon {font-size: 12px;}\n"
+                                  "    }\n"
+                                  "    margin: 1px;\n"
+                                  "}\n"
+                                  ".empty {unknown-rule: 1;}\n"
+                                  "#last {font-size: 2;}\n";
+        std::cout << "Tested style:\n" << style << "deserialized from the nodes and from a flat tree\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+        flatStyleDefinitions = style::StyleDeserializer::deserialize(style::Parser().parseFlat(style, config), 1, &flatRuleNumber, config);
+        result = checkStyleDefinitions(flatStyleDefinitions, styleDefinitions);
+        if (result == test::Result::SUCCESS && flatRuleNumber != ruleNumber) result = test::Result::FAILURE;
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        for (style::StyleDefinition *component : *flatStyleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete flatStyleDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testStyleCompilation() {
+        int ruleNumber;
+        int compiledRuleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *> *compiledStyleDefinitions;
+        test::Result result = test::Result::SUCCESS;
+        // the second style moves the first block in the selector of the second one, so it is converted by NodesToStyleComponents
+        const std::string styles[] = {"window, .main label {\n"
+                                      "    padding: 3px;\n"
+                                      "    unknown-rule: 2;\n"
+                                      "    &:hover, button {\n"
+                                      "        text-color: #ff0000;\n"
+                                      "        > .icon {font-size: 12px;}\n"
+                                      "    }\n"
+                                      "    margin: (1px, 2px);\n"
+                                      "    text-color: #00ff00;\n"
+                                      "}\n"
+                                      ".empty {unknown-rule: 1;}\n"
+                                      "#last {font-size: 2;}\n",
+                                      "label {padding: 1px;} .blue {font-size: 2;}"};
+        const bool converted[] = {false, true};
+        style::StyleCompiler compiler(config);
+        for (size_t i = 0; i < 2; i++) {
+            const std::string &style = styles[i];
+            std::cout << "Tested style:\n" << style << "\ncompiled and deserialized\n";
+            styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+            compiledStyleDefinitions = compiler.compile(style, 1, &compiledRuleNumber);
+            if (result == test::Result::SUCCESS) result = checkStyleDefinitions(compiledStyleDefinitions, styleDefinitions);
+            if (result == test::Result::SUCCESS && compiledRuleNumber != ruleNumber) result = test::Result::FAILURE;
+            // the single pass compilation must not fall back on the pipeline for the styles it handles
+            if (compiler.converted() != converted[i]) result = test::Result::FAILURE;
+
+            for (style::StyleDefinition *component : *styleDefinitions) {
+                delete component;
+            }
+            for (style::StyleDefinition *component : *compiledStyleDefinitions) {
+                delete component;
+            }
+            delete styleDefinitions;
+            delete compiledStyleDefinitions;
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result testStyleCompilationLexerError() {
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        style::StyleCompiler compiler(config);
+        test::Result result;
+        const std::string style = "a {padding: 1px;}\nb {padding: $;}\n";
+        std::cout << "Test if compiling\n" << style << "raises the lexer exception without converting the style again : ";
+        try {
+            delete compiler.compile(style, 1, &ruleNumber);
+            result = test::Result::FAILURE;
+        }
+        catch (const style::UnknownValue &) {
+            result = compiler.converted() ? test::Result::FAILURE : test::Result::SUCCESS;
+        }
+        catch (const std::exception &e) {
+            result = test::Result::ERROR;
+            std::cerr << "Error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return result;
+    }
+
+    test::Result testDeserializationWithSameConverter() {
+        int ruleNumber;
+        int convertedRuleNumber;
+        style::config::Config *config = testConfig();
+        style::NodesToStyleComponents converter(config);
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *> *convertedStyleDefinitions;
+        test::Result result = test::Result::SUCCESS;
+        const std::string styles[] = {"window {\n    padding: 3px;\n    &:hover {text-color: #ff0000;}\n}\n", "label {padding: 1px;}",
+                                      "a {b: 1;}\nc {d: 1}", "window {\n    padding: 3px;\n    &:hover {text-color: #ff0000;}\n}\n"};
+        for (const std::string &style : styles) {
+            std::cout << "Tested style:\n" << style << "\nconverted with the converter of the previous styles\n";
+            try {
+                convertedStyleDefinitions = converter.convert(style, 1, &convertedRuleNumber);
+            }
+            catch (const std::exception &) {
+                convertedStyleDefinitions = nullptr;
+            }
+            try {
+                styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+            }
+            catch (const std::exception &) {
+                styleDefinitions = nullptr;
+            }
+            if ((styleDefinitions == nullptr) != (convertedStyleDefinitions == nullptr)) result = test::Result::FAILURE;
+            if (styleDefinitions == nullptr || convertedStyleDefinitions == nullptr) {
+                delete styleDefinitions;
+                delete convertedStyleDefinitions;
+                continue;
+            }
+            if (result == test::Result::SUCCESS) result = checkStyleDefinitions(convertedStyleDefinitions, styleDefinitions);
+            if (result == test::Result::SUCCESS && convertedRuleNumber != ruleNumber) result = test::Result::FAILURE;
+
+            for (style::StyleDefinition *component : *styleDefinitions) {
+                delete component;
+            }
+            for (style::StyleDefinition *component : *convertedStyleDefinitions) {
+                delete component;
+            }
+            delete styleDefinitions;
+            delete convertedStyleDefinitions;
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result testCompiledConfigDeserialization() {
+        int ruleNumber;
+        int compiledRuleNumber;
+        style::config::Config *config = testConfig();
+        config->rules["alignment"] = {new style::config::ConfigRuleNodeEnum({"left", "right"})};
+        const style::config::CompiledConfig compiledConfig(config);
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *> *compiledStyleDefinitions[3];
+        test::Result result = test::Result::SUCCESS;
+        const std::string style = "window {\n"
+                                  "    padding: 3px;\n"
+                                  "    alignment: left;\n"
+                                  "    &:hover {alignment: center; text-color: #ff0000;}\n"
+                                  "}\n"
+                                  "label {alignment: right; unknown-rule: 1;}\n";
+        std::cout << "Tested style:\n" << style << "deserialized with the config and with the compiled config\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+        compiledStyleDefinitions[0] = style::StyleDeserializer::deserialize(style, 1, &compiledRuleNumber, &compiledConfig);
+        compiledStyleDefinitions[1] = style::StyleDeserializer::compile(style, 1, &compiledRuleNumber, &compiledConfig);
+        compiledStyleDefinitions[2] =
+            style::StyleDeserializer::deserialize(style::Parser().parseFlat(style, config), 1, &compiledRuleNumber, &compiledConfig);
+        for (std::list<style::StyleDefinition *> *definitions : compiledStyleDefinitions) {
+            if (result == test::Result::SUCCESS) result = checkStyleDefinitions(definitions, styleDefinitions);
+            if (result == test::Result::SUCCESS && compiledRuleNumber != ruleNumber) result = test::Result::FAILURE;
+            for (style::StyleDefinition *component : *definitions) {
+                delete component;
+            }
+            delete definitions;
+        }
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testStructuralRuleValidation() {
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        config->rules["margin"] = {
+            new style::config::ConfigRuleNode(
+                style::Token::Tuple,
+                new style::config::ConfigRuleNode(style::Token::Int, nullptr, new style::config::ConfigRuleNode(style::Token::Int))),
+            new style::config::ConfigRuleNode(
+                style::Token::Tuple,
+                new style::config::ConfigRuleNode(style::Token::Int, nullptr,
+                                                  new style::config::ConfigRuleNode(style::Token::Unit,
+                                                                                    new style::config::ConfigRuleNode(style::Token::Int))))};
+        config->rules["alignment"] = {new style::config::ConfigRuleNodeEnum({"left", "right"})};
+        std::list<style::StyleDefinition *> *styleDefinitions[3];
+        test::Result result = test::Result::SUCCESS;
+        // the whole values are validated, not only their first token
+        const std::string style = "window {\n"
+                                  "    padding: 3px;\n"
+                                  "    margin: (1, 2px);\n"
+                                  "    alignment: left;\n"
+                                  "}\n"
+                                  "label {\n"
+                                  "    margin: (1px, 2);\n"
+                                  "    margin: (1, 2, 3);\n"
+                                  "    margin: (1, true);\n"
+                                  "    alignment: center;\n"
+                                  "    text-color: #ffffff;\n"
+                                  "}\n";
+        const std::vector<std::set<std::string>> expectedRules = {{"padding", "margin", "alignment"}, {"text-color"}};
+        std::cout << "Tested style:\n" << style << "deserialized, compiled and deserialized from a flat tree\n";
+        styleDefinitions[0] = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+        styleDefinitions[1] = style::StyleDeserializer::compile(style, 1, &ruleNumber, config);
+        styleDefinitions[2] = style::StyleDeserializer::deserialize(style::Parser().parseFlat(style, config), 1, &ruleNumber, config);
+        for (std::list<style::StyleDefinition *> *definitions : styleDefinitions) {
+            std::vector<std::set<std::string>> rules;
+            for (style::StyleDefinition *definition : *definitions) {
+                rules.emplace_back();
+                for (const std::pair<const std::string, style::StyleRule> &rule : *definition->second) {
+                    rules.back().insert(rule.first);
+                }
+                delete definition;
+            }
+            if (rules != expectedRules) result = test::Result::FAILURE;
+            delete definitions;
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result testIndexedRules() {
+        int ruleNumber;
+        int indexedRuleNumber;
+        style::config::Config *config = testConfig();
+        const style::config::CompiledConfig compiledConfig(config);
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::IndexedStyleDefinition *> *indexedDefinitions;
+        std::list<style::IndexedStyleDefinition *>::const_iterator indexedDefinition;
+        test::Result result = test::Result::SUCCESS;
+        const std::string style = "window, .main label {\n"
+                                  "    text-color: #ff0000;\n"
+                                  "    padding: 3px;\n"
+                                  "    &:hover {padding: 4px;}\n"
+                                  "}\n"
+                                  "button {padding: 2px;}\n";
+        std::cout << "Tested style:\n" << style << "deserialized with its rules indexed by their ids\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+        indexedDefinitions = style::StyleDeserializer::deserializeIndexed(style, 1, &indexedRuleNumber, &compiledConfig);
+        if (indexedDefinitions->size() != styleDefinitions->size() || indexedRuleNumber != ruleNumber) result = test::Result::FAILURE;
+        indexedDefinition = indexedDefinitions->cbegin();
+        for (std::list<style::StyleDefinition *>::const_iterator styleDefinition = styleDefinitions->cbegin();
+             result == test::Result::SUCCESS && styleDefinition != styleDefinitions->cend(); styleDefinition++, indexedDefinition++) {
+            result = checkStyleComponentDataList(&(*indexedDefinition)->first, &(*styleDefinition)->first);
+            if ((*indexedDefinition)->specificity != (*styleDefinition)->specificity) result = test::Result::FAILURE;
+            if ((*indexedDefinition)->second->size() != (*styleDefinition)->second->size()) result = test::Result::FAILURE;
+            for (const std::pair<const std::string, style::StyleRule> &rule : *(*styleDefinition)->second) {
+                if (result == test::Result::SUCCESS) {
+                    result = checkStyleRule((*indexedDefinition)->second->find(compiledConfig.ruleId(rule.first)), &rule.second);
+                }
+            }
+        }
+        // the selectors of a block share its indexed rules, sorted by their ids
+        if (result == test::Result::SUCCESS) {
+            indexedDefinition = indexedDefinitions->cbegin();
+            if ((*indexedDefinition)->second != (*std::next(indexedDefinition))->second ||
+                (*indexedDefinition)->second->begin()->first != compiledConfig.ruleId("padding") ||
+                indexedDefinitions->back()->second->find(compiledConfig.ruleId("text-color")) != nullptr) {
+                result = test::Result::FAILURE;
+            }
+        }
+        // the rules still held outside of the indexed list are copied and not moved
+        if (result == test::Result::SUCCESS) {
+            std::list<style::StyleDefinition *> *heldDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+            std::shared_ptr<const style::StyleValuesMap> heldRules = heldDefinitions->front()->second;
+            std::list<style::IndexedStyleDefinition *> *heldIndexedDefinitions = style::indexStyleDefinitions(heldDefinitions, &compiledConfig);
+            if (heldRules->size() != styleDefinitions->front()->second->size()) result = test::Result::FAILURE;
+            for (const std::pair<const std::string, style::StyleRule> &rule : *styleDefinitions->front()->second) {
+                if (result == test::Result::SUCCESS) result = checkStyleRule(&heldRules->at(rule.first), &rule.second);
+            }
+            for (style::IndexedStyleDefinition *component : *heldIndexedDefinitions) {
+                delete component;
+            }
+            delete heldIndexedDefinitions;
+        }
+
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        for (style::IndexedStyleDefinition *component : *indexedDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        delete indexedDefinitions;
+        delete config;
+        return result;
+    }
+
+    test::Result testSharedBlockRules() {
+        int ruleNumber;
+        style::config::Config *config = testConfig();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        std::list<style::StyleDefinition *>::const_iterator definition;
+        test::Result result = test::Result::SUCCESS;
+        const std::string style = "a, .b, #c {padding: 1px;}\nlabel {padding: 2px;}\n";
+        const int specificities[] = {1, 10, 100, 1};
+        std::cout << "Test if the selectors of a block share its rules, with their own specificity, in:\n" << style << "\n";
+        for (int conversion = 0; conversion < 3; conversion++) {
+            if (conversion == 0) styleDefinitions = style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+            else if (conversion == 1) styleDefinitions = style::StyleDeserializer::compile(style, 1, &ruleNumber, config);
+            else styleDefinitions = style::StyleDeserializer::deserialize(style::Parser().parseFlat(style, config), 1, &ruleNumber, config);
+            if (styleDefinitions->size() != 4) result = test::Result::FAILURE;
+            else {
+                definition = styleDefinitions->cbegin();
+                for (int specificity : specificities) {
+                    if ((*definition)->specificity != specificity) result = test::Result::FAILURE;
+                    definition++;
+                }
+                definition = styleDefinitions->cbegin();
+                for (int i = 0; i < 2; i++) {
+                    if ((*definition)->second != (*std::next(definition))->second) result = test::Result::FAILURE;
+                    definition++;
+                }
+                if ((*definition)->second == (*std::next(definition))->second) result = test::Result::FAILURE;
+            }
+            for (style::StyleDefinition *component : *styleDefinitions) {
+                delete component;
+            }
+            delete styleDefinitions;
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result testDeepAndLongValues() {
+        const int valuesCount = 100000;
+        int ruleNumber;
+        int count;
+        style::config::Config *config = testConfig();
+        config->rules["values"] = {new style::config::ConfigRuleNode(style::Token::Tuple)};
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        style::StyleValuesMap::const_iterator rule;
+        const style::StyleValue *value;
+        test::Result result = test::Result::SUCCESS;
+        std::string longTuple = "(1";
+        for (int i = 1; i < valuesCount; i++) {
+            longTuple += ", 1";
+        }
+        longTuple += ")";
+        const std::string styles[] = {"label {values: " + std::string(valuesCount, '(') + "1" + std::string(valuesCount, ')') + ";}",
+                                      "label {values: " + longTuple + ";}"};
+        std::cout << "Test if " << valuesCount << " nested tuples and a tuple of " << valuesCount << " values are deserialized and compiled\n";
+        for (bool nested : {true, false}) {
+            for (bool compiled : {false, true}) {
+                const std::string &style = styles[nested ? 0 : 1];
+                styleDefinitions = compiled ? style::StyleDeserializer::compile(style, 1, &ruleNumber, config)
+                                            : style::StyleDeserializer::deserialize(style, 1, &ruleNumber, config);
+                // the values are counted without recursion, like they are copied and deleted
+                count = 0;
+                if (styleDefinitions->size() == 1) rule = styleDefinitions->front()->second->find("values");
+                if (styleDefinitions->size() == 1 && rule != styleDefinitions->front()->second->cend()) {
+                    value = rule->second.value;
+                    while (nested && value != nullptr && value->type() == style::StyleValueType::Tuple) {
+                        count++;
+                        value = value->child();
+                    }
+                    for (value = nested ? nullptr : value->child(); value != nullptr; value = value->next()) {
+                        count++;
+                    }
+                }
+                if (count != valuesCount) result = test::Result::FAILURE;
+                for (style::StyleDefinition *component : *styleDefinitions) {
+                    delete component;
+                }
+                delete styleDefinitions;
+            }
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result checkIncrementalStyle(const style::IncrementalStyle &incrementalStyle, const style::config::Config *config) {
+        int ruleNumber;
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        test::Result result;
+        std::cout << "Edited style:\n" << incrementalStyle.style() << "\n";
+        styleDefinitions = style::StyleDeserializer::deserialize(incrementalStyle.style(), 1, &ruleNumber, config);
+        result = checkStyleDefinitions(&incrementalStyle.definitions(), styleDefinitions);
+        if (result == test::Result::SUCCESS && incrementalStyle.rulesCount() != ruleNumber) result = test::Result::FAILURE;
+        for (style::StyleDefinition *component : *styleDefinitions) {
+            delete component;
+        }
+        delete styleDefinitions;
+        return result;
+    }
+
+    test::Result testIncrementalDeserialization() {
+        style::config::Config *config = testConfig();
+        test::Result result = test::Result::SUCCESS;
+        style::IncrementalStyle incrementalStyle("window {\n"
+                                                 "    padding: 3px;\n"
+                                                 "    &:hover {text-color: #ff0000;}\n"
+                                                 "}\n"
+                                                 ".empty {unknown-rule: 1px;}\n"
+                                                 "label {\n"
+                                                 "    padding: 2px;\n"
+                                                 "}\n",
+                                                 1, config);
+        const style::StyleDefinition *lastDefinition = incrementalStyle.definitions().back();
+        // rules read before the edits, their numbers aren't shifted by them
+        std::shared_ptr<const style::StyleValuesMap> lastRules = lastDefinition->second;
+        int lastRuleNumber = lastRules->at("padding").ruleNumber;
+        size_t position;
+        // each edit replaces the given number of characters at the start of the first occurrence of a text
+        const std::tuple<std::string, size_t, std::string> edits[] = {
+            // a value, then a new rule, shifting the rules numbers of the next blocks
+            {"3px", 1, "5"},
+            {"    &:hover", 0, "    text-color: #fff;\n"},
+            // the rule of the empty block becomes valid
+            {"unknown-rule", 12, "padding"},
+            // a block moving the end of the previous one in its selector, then separated from it again
+            {"\nlabel", 0, " #id {padding: 2px;}"},
+            {" #id", 1, "\n"},
+            // an unclosed block makes the style invalid, the next edit deserializes it again
+            {"{\n    padding", 0, "{"},
+            {"{{", 1, ""},
+            // an unknown character is a lexer error, raised without deserializing the style entirely
+            {"2px", 0, "$"},
+            {"$", 1, ""},
+        };
+        result = checkIncrementalStyle(incrementalStyle, config);
+        for (size_t i = 0; i < std::size(edits) && result == test::Result::SUCCESS; i++) {
+            position = incrementalStyle.style().find(std::get<0>(edits[i]));
+            try {
+                incrementalStyle.edit(position, std::get<1>(edits[i]), std::get<2>(edits[i]));
+            }
+            catch (const std::exception &exception) {
+                std::cout << "Invalid edit: " << exception.what() << "\n";
+                if (!incrementalStyle.definitions().empty()) result = test::Result::FAILURE;
+                continue;
+            }
+            result = checkIncrementalStyle(incrementalStyle, config);
+            // the definitions of the last block are reused by the edits of the other blocks
+            if (result == test::Result::SUCCESS && i < 3 && incrementalStyle.definitions().back() != lastDefinition) result = test::Result::FAILURE;
+        }
+        if (result == test::Result::SUCCESS && lastRules->at("padding").ruleNumber != lastRuleNumber) result = test::Result::FAILURE;
+        delete config;
+        return result;
+    }
+
+    test::Result testIncrementalDeserializationWithCommentChunk() {
+        style::config::Config *config = testConfig();
+        test::Result result = test::Result::SUCCESS;
+        // the comment after the last block is a chunk without definitions
+        style::IncrementalStyle incrementalStyle("label {padding: 1px;}\n/* only a comment */\n", 1, config);
+        size_t position;
+        const std::tuple<std::string, size_t, std::string> edits[] = {
+            {"1px", 1, "2"},
+            {"only", 4, "still only"},
+            {"/*", 0, "button {padding: 3px;}\n"},
+            {"2px", 1, "4"},
+        };
+        result = checkIncrementalStyle(incrementalStyle, config);
+        for (size_t i = 0; i < std::size(edits) && result == test::Result::SUCCESS; i++) {
+            position = incrementalStyle.style().find(std::get<0>(edits[i]));
+            incrementalStyle.edit(position, std::get<1>(edits[i]), std::get<2>(edits[i]));
+            result = checkIncrementalStyle(incrementalStyle, config);
+        }
+        delete config;
+        return result;
+    }
+
+    test::Result testIncrementalDeserializationWithInvalidEdits() {
+        style::config::Config *config = testConfig();
+        test::Result result = test::Result::SUCCESS;
+        style::IncrementalStyle incrementalStyle("window {\n"
+                                                 "    padding: 3px;\n"
+                                                 "}\n"
+                                                 "/* a comment */\n"
+                                                 "label {padding: 2px;}\n"
+                                                 "button {padding: 1px;}\n",
+                                                 1, config);
+        const style::StyleDefinition *lastDefinition = incrementalStyle.definitions().back();
+        std::list<style::StyleDefinition *> *styleDefinitions;
+        int ruleNumber;
+        size_t position;
+        // the last block is never edited, its definitions are kept while the style is invalid
+        const std::tuple<std::string, size_t, std::string> edits[] = {
+            // a comment closed by the one of the next chunk
+            {"window", 0, "/*"},
+            {"/*window", 2, ""},
+            // an unclosed block, edited until it is closed again
+            {"}\n/*", 1, ""},
+            {"3px", 1, "5"},
+            {"5px;\n", 5, "5px;\n}"},
+            // a closing curly bracket without an opening one
+            {"label", 0, "}"},
+            {"}label", 1, "label"},
+            // an unknown character
+            {"2px", 0, "$"},
+            {"$", 1, ""},
+        };
+        std::cout << "Test if the edits making the style invalid give an error, and if the next ones make it valid again\n";
+        for (size_t i = 0; i < std::size(edits) && result == test::Result::SUCCESS; i++) {
+            position = incrementalStyle.style().find(std::get<0>(edits[i]));
+            try {
+                incrementalStyle.edit(position, std::get<1>(edits[i]), std::get<2>(edits[i]));
+            }
+            catch (const std::exception &exception) {
+                std::cout << "Invalid edit: " << exception.what() << "\n";
+                if (!incrementalStyle.definitions().empty() || incrementalStyle.rulesCount() != 0) result = test::Result::FAILURE;
+                // the edited style must be invalid too
+                try {
+                    styleDefinitions = style::StyleDeserializer::deserialize(incrementalStyle.style(), 1, &ruleNumber, config);
+                    for (style::StyleDefinition *component : *styleDefinitions) {
+                        delete component;
+                    }
+                    delete styleDefinitions;
+                    result = test::Result::FAILURE;
+                }
+                catch (const std::exception &) {
+                }
+                continue;
+            }
+            result = checkIncrementalStyle(incrementalStyle, config);
+            if (result == test::Result::SUCCESS && incrementalStyle.definitions().back() != lastDefinition) result = test::Result::FAILURE;
+        }
+        delete config;
+        return result;
+    }
+
     void testsDeserialization(test::Tests *tests) {
         tests->beginTestBlock("Deserialization tests");
         tests->addTest(testSingleRule, "Deserializing a single rule");
@@ -445,6 +1173,24 @@ namespace deserializationTests {
         tests->addTest(testMissingBlockDeclaration, "Missing block declaration");
         tests->addTest(testMissingBlockDeclarationComponentBeforeDirectParentRelation,
                        "Missing block declaration component before direct parent relation");
+        tests->addTest(testDecodedNumber, "Decoded number");
+        tests->addTest(testDecodedHexColor, "Decoded hex color");
+        tests->addTest(testNestedBlockInSeveralSelectors, "Nested block in several selectors");
+        tests->addTest(testNestedBlockWithSeveralSelectors, "Nested block with several selectors");
+        tests->addTest(testSameElementWithSeveralParentSelectors, "Same element relation with several parent selectors");
+        tests->addTest(testParallelDeserialization, "Parallel deserialization");
+        tests->addTest(testFlatTreeDeserialization, "Flat tree deserialization");
+        tests->addTest(testStyleCompilation, "Style compilation");
+        tests->addTest(testStyleCompilationLexerError, "Style compilation lexer error");
+        tests->addTest(testIncrementalDeserialization, "Incremental deserialization");
+        tests->addTest(testIncrementalDeserializationWithCommentChunk, "Incremental deserialization with a comment chunk");
+        tests->addTest(testIncrementalDeserializationWithInvalidEdits, "Incremental deserialization with invalid edits");
+        tests->addTest(testDeserializationWithSameConverter, "Deserialization with the same converter");
+        tests->addTest(testSharedBlockRules, "Shared block rules");
+        tests->addTest(testCompiledConfigDeserialization, "Compiled config deserialization");
+        tests->addTest(testStructuralRuleValidation, "Structural rule validation");
+        tests->addTest(testIndexedRules, "Indexed rules");
+        tests->addTest(testDeepAndLongValues, "Deep and long values");
         tests->beginTestBlock("specificities");
         tests->addTest(testElementNameSpecificity, "Element name specificity");
         tests->addTest(testClassSpecificity, "Class specificity");
@@ -2,6 +2,9 @@
 #define DESERIALIZATION_TESTS_HPP
 
 #include "../../cpp_tests/src/tests.hpp"
+#include "../../src/incremental_style.hpp"
+#include "../../src/nodes_to_style_components.hpp"
+#include "../../src/style_compiler.hpp"
 #include "../../src/style_deserializer.hpp"
 #include "../test_config.hpp"
 
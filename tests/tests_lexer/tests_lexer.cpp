@@ -457,6 +457,432 @@ namespace testsLexer {
         return result;
     }
 
+    test::Result testLexingBoolFollowedByRawName() {
+        style::DeserializationNode *rootExpected;
+        test::Result result;
+
+        rootExpected = new style::DeserializationNode(style::Token::Bool, "true");
+        rootExpected->appendNext(new style::DeserializationNode(style::Token::RawName, "ly"));
+        result = testLexer(true, "truely", rootExpected);
+        delete rootExpected;
+        return result;
+    }
+
+    test::Result testLexingNumbersAndUnits() {
+        style::DeserializationNode *rootExpected;
+        test::Result result;
+
+        rootExpected = new style::DeserializationNode(style::Token::OpeningParenthesis);
+        rootExpected->appendNext(new style::DeserializationNode(style::Token::Int, "-5"))
+            ->appendNext(new style::DeserializationNode(style::Token::Unit, "px"))
+            ->appendNext(new style::DeserializationNode(style::Token::Comma))
+            ->appendNext(new style::DeserializationNode(style::Token::Int, "10"))
+            ->appendNext(new style::DeserializationNode(style::Token::Unit, "%"))
+            ->appendNext(new style::DeserializationNode(style::Token::ClosingParenthesis))
+            ->appendNext(new style::DeserializationNode(style::Token::Space))
+            ->appendNext(new style::DeserializationNode(style::Token::RawName, "2a"));
+        result = testLexer(true, "(-5px,10%) 2a", rootExpected);
+        delete rootExpected;
+        return result;
+    }
+
+    test::Result testLexingLongestUnit() {
+        // "p" is declared before "px" and "pxl", but can't shadow them
+        style::config::Config config = style::config::Config{{}, {"p", "pxl", "px"}};
+        const std::string expression = "10px 5pxl 3p";
+        const std::vector<style::Token> expectedTokens = {style::Token::Int,   style::Token::Unit, style::Token::Space, style::Token::Int,
+                                                          style::Token::Unit,  style::Token::Space, style::Token::Int,  style::Token::Unit};
+        const std::vector<std::string> expectedUnits = {"px", "pxl", "p"};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nmatches the longest units\n";
+        try {
+            style::TokenStream tokens = style::Lexer().lexeTokens(expression, &config);
+            std::vector<std::string> units;
+            if (tokens.size() != expectedTokens.size()) testResult = test::Result::FAILURE;
+            for (size_t i = 0; i < tokens.size() && i < expectedTokens.size(); i++) {
+                if (tokens[i].token != expectedTokens[i]) testResult = test::Result::FAILURE;
+                if (tokens[i].token == style::Token::Unit) units.push_back(std::string(tokens.value(tokens[i])));
+            }
+            if (units != expectedUnits) testResult = test::Result::FAILURE;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingNumberDiagnostics() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "99999999999999999999 -99999999999999999999 12 1.23456789012345678";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nreports overflows and precision losses\n";
+        try {
+            style::TokenStream tokens = style::Lexer().lexeTokens(expression, config);
+            if (tokens.size() != 7) testResult = test::Result::FAILURE;
+            else {
+                if (tokens[0].number.diagnostic != style::NumberDiagnostic::Overflow || tokens[0].number.intValue != INT64_MAX)
+                    testResult = test::Result::FAILURE;
+                if (tokens[2].number.diagnostic != style::NumberDiagnostic::Overflow || tokens[2].number.intValue != INT64_MIN)
+                    testResult = test::Result::FAILURE;
+                if (tokens[4].number.diagnostic != style::NumberDiagnostic::None || tokens[4].number.intValue != 12) testResult = test::Result::FAILURE;
+                if (tokens[6].token != style::Token::Float || tokens[6].number.diagnostic != style::NumberDiagnostic::PrecisionLoss)
+                    testResult = test::Result::FAILURE;
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingCommentsSkipped() {
+        style::DeserializationNode *rootExpected;
+        test::Result result;
+
+        rootExpected = new style::DeserializationNode(style::Token::RawName, "a");
+        rootExpected->appendNext(new style::DeserializationNode(style::Token::Space))
+            ->appendNext(new style::DeserializationNode(style::Token::LineBreak))
+            ->appendNext(new style::DeserializationNode(style::Token::RawName, "b"));
+        result = testLexer(true, "a/* comment */ // comment\nb", rootExpected);
+        delete rootExpected;
+        return result;
+    }
+
+    test::Result testLexingWhiteSpacesFlags() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a b/* comment */\n {c}  ";
+        const std::vector<style::Token> expectedTokens = {style::Token::RawName, style::Token::RawName, style::Token::OpeningCurlyBracket,
+                                                          style::Token::RawName, style::Token::ClosingCurlyBracket};
+        const std::vector<uint8_t> expectedFlags = {0, style::PRECEDED_BY_SPACE, style::PRECEDED_BY_SPACE | style::PRECEDED_BY_LINE_BREAK, 0, 0};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nwithout white space tokens gives white spaces flags\n";
+        try {
+            style::TokenStream tokens = style::Lexer(false, false).lexeTokens(expression, config);
+            if (tokens.size() != expectedTokens.size()) testResult = test::Result::FAILURE;
+            else {
+                for (size_t i = 0; i < tokens.size(); i++) {
+                    if (tokens[i].token != expectedTokens[i] || tokens[i].flags != expectedFlags[i]) testResult = test::Result::FAILURE;
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingPullMode() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a.b > #c {\n  d: 10px /* e */ (1, 2.5);\n  f: 'g' true;\n}\n";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\none token at a time gives the same tokens as lexing all of them\n";
+        try {
+            style::TokenStream expected = style::Lexer(false, false).lexeTokens(expression, config);
+            style::Lexer lexer(false, false);
+            style::LexedToken token;
+            size_t i = 0;
+            lexer.start(expression, config);
+            while (lexer.nextToken(&token)) {
+                if (i >= expected.size() || token.token != expected[i].token || token.start != expected[i].start || token.length != expected[i].length ||
+                    token.flags != expected[i].flags)
+                    testResult = test::Result::FAILURE;
+                i++;
+            }
+            if (i != expected.size()) testResult = test::Result::FAILURE;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingCommentsKept() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a/* multi line */ // one line\nb";
+        const std::vector<style::Token> expectedTokens = {style::Token::RawName,   style::Token::MultiLineComment, style::Token::Space,
+                                                          style::Token::OneLineComment, style::Token::LineBreak,  style::Token::RawName};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nkeeping the comments gives comment tokens\n";
+        try {
+            style::TokenStream tokens = style::Lexer(true).lexeTokens(expression, config);
+            if (tokens.size() != expectedTokens.size()) testResult = test::Result::FAILURE;
+            else {
+                for (size_t i = 0; i < tokens.size(); i++) {
+                    if (tokens[i].token != expectedTokens[i]) testResult = test::Result::FAILURE;
+                }
+                if (tokens.value(tokens[1]) != " multi line " || tokens.value(tokens[3]) != " one line") testResult = test::Result::FAILURE;
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingInPlace() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "label.blue {\n    text-color: \"a string\";\n    padding: 10px;\n}";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing in place\n'\n" << expression << "\n'\ngives the same tokens as lexing with copies, referencing the expression\n";
+        try {
+            style::DeserializationNode *copiedTokens = style::Lexer().lexe(expression, config);
+            style::DeserializationNode *borrowedTokens = style::Lexer().lexeInPlace(expression, config);
+            const style::DeserializationNode *copied = copiedTokens;
+            const style::DeserializationNode *borrowed = borrowedTokens;
+            while (copied != nullptr && borrowed != nullptr) {
+                if (*copied != *borrowed) testResult = test::Result::FAILURE;
+                if (!borrowed->value().empty()
+                    && (!borrowed->borrowsValue()
+                        || borrowed->value().data() < expression.data()
+                        || borrowed->value().data() + borrowed->value().size() > expression.data() + expression.size()))
+                    testResult = test::Result::FAILURE;
+                copied = copied->next();
+                borrowed = borrowed->next();
+            }
+            if (copied != nullptr || borrowed != nullptr) testResult = test::Result::FAILURE;
+            delete copiedTokens;
+            delete borrowedTokens;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingTokenStream() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a {b: -12px;} 7.5";
+        const std::vector<style::Token> expectedTokens = {
+            style::Token::RawName, style::Token::Space, style::Token::OpeningCurlyBracket, style::Token::RawName,
+            style::Token::Colon,   style::Token::Space, style::Token::Int,                 style::Token::Unit,
+            style::Token::SemiColon, style::Token::ClosingCurlyBracket, style::Token::Space, style::Token::Float};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nin a token stream gives the expected tokens and numbers\n";
+        try {
+            style::TokenStream tokens = style::Lexer().lexeTokens(expression, config);
+            if (tokens.size() != expectedTokens.size()) testResult = test::Result::FAILURE;
+            else {
+                for (size_t i = 0; i < tokens.size(); i++) {
+                    if (tokens[i].token != expectedTokens[i]) testResult = test::Result::FAILURE;
+                }
+                if (tokens.value(tokens[6]) != "-12" || tokens[6].number.intValue != -12) testResult = test::Result::FAILURE;
+                if (tokens.value(tokens[7]) != "px") testResult = test::Result::FAILURE;
+                if (tokens.value(tokens[11]) != "7.5" || tokens[11].number.floatValue != 7.5) testResult = test::Result::FAILURE;
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testCopiedTokenStreamOwningValues() {
+        const std::string value = "label";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if the copy of a stream owning its values keeps them when tokens are pushed to the stream\n";
+        style::TokenStream tokens = style::TokenStream::owningValues();
+        tokens.pushValue(style::Token::RawName, value);
+        style::TokenStream copy = tokens;
+        // enough values to reallocate the ones of the stream
+        for (int i = 0; i < 1000; i++) {
+            tokens.pushValue(style::Token::RawName, "padding");
+            tokens.pushValue(tokens[0], value);
+        }
+        if (copy.size() != 1 || copy.value(copy[0]) != value || tokens.size() != 2001) testResult = test::Result::FAILURE;
+        // the values of the copy aren't the ones added to the stream
+        copy.discard(0);
+        if (copy.expression() != value) testResult = test::Result::FAILURE;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingStream() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "/* multi line\ncomment */\nlabel.blue > button, #id {\n    // one line comment\n    padding: -10px 5%;\n"
+                                       "    text: \"a string\" 'an other';\n    enabled: true;\n}\n0.5";
+        const std::vector<size_t> chunkSizes = {1, 2, 3, 5, 7, 16, DEFAULT_STREAM_CHUNK_SIZE};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nby chunks gives the same tokens as lexing it entirely\n";
+        try {
+            style::TokenStream expected = style::Lexer().lexeTokens(expression, config);
+            for (size_t chunkSize : chunkSizes) {
+                std::istringstream input(expression);
+                style::TokenStream tokens = style::Lexer().lexeStream(input, config, chunkSize);
+                if (tokens.size() != expected.size()) testResult = test::Result::FAILURE;
+                for (size_t i = 0; i < tokens.size() && i < expected.size(); i++) {
+                    if (tokens[i].token != expected[i].token || tokens.value(tokens[i]) != expected.value(expected[i]))
+                        testResult = test::Result::FAILURE;
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingStreamWithReadCallback() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a {b: 12px;}";
+        size_t position = 0;
+        size_t maxReadSize = 0;
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nfrom a read callback only reads by chunks\n";
+        try {
+            style::TokenStream tokens = style::Lexer().lexeStream(
+                [&](char *buffer, size_t size) {
+                    maxReadSize = std::max(maxReadSize, size);
+                    size_t count = expression.copy(buffer, size, position);
+                    position += count;
+                    return count;
+                },
+                config, 4);
+            style::TokenStream expected = style::Lexer().lexeTokens(expression, config);
+            if (tokens.size() != expected.size() || maxReadSize > 8) testResult = test::Result::FAILURE;
+            for (size_t i = 0; i < tokens.size() && i < expected.size(); i++) {
+                if (tokens[i].token != expected[i].token || tokens.value(tokens[i]) != expected.value(expected[i])) testResult = test::Result::FAILURE;
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingWithSameLexer() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a.b > #c {\n  d: 10px (1, 2.5);\n}\n";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\nwith a lexer already used, even by a failed lexing, gives the same tokens in the same memory\n";
+        try {
+            style::TokenStream expected = style::Lexer().lexeTokens(expression, config);
+            style::Lexer lexer;
+            std::vector<style::TokenStream> results;
+            style::LexedToken token;
+            results.push_back(lexer.lexeTokens(expression, config));
+            try {
+                lexer.lexeTokens("a {b: 'c}", config);
+                testResult = test::Result::FAILURE;
+            }
+            catch (const style::UnknownValue &) {
+            }
+            results.push_back(lexer.lexeTokens(expression, config));
+            lexer.start(expression, config);
+            lexer.nextToken(&token);
+            lexer.reset();
+            results.push_back(lexer.lexeTokens(expression, config));
+            // the tokens are lexed again in the memory kept by the lexer
+            const style::LexedToken *firstToken = &lexer.lexeTokens(expression, config)[0];
+            if (&lexer.lexeTokens(expression, config)[0] != firstToken) testResult = test::Result::FAILURE;
+            for (const style::TokenStream &tokens : results) {
+                if (tokens.size() != expected.size()) testResult = test::Result::FAILURE;
+                for (size_t i = 0; i < tokens.size() && i < expected.size(); i++) {
+                    if (tokens[i].token != expected[i].token || tokens.value(tokens[i]) != expected.value(expected[i]))
+                        testResult = test::Result::FAILURE;
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    const std::vector<style::scanner::Implementation> SCANNER_IMPLEMENTATIONS = {
+        style::scanner::Implementation::Scalar, style::scanner::Implementation::Sse2, style::scanner::Implementation::Avx2};
+
+    test::Result testScannersMatchScalar() {
+        const std::string alphabet = " \t\n*/\"'a";
+        std::mt19937 generator(42);
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if every supported scanner implementation gives the same results as the scalar one\n";
+        style::scanner::Implementation defaultImplementation = style::scanner::currentImplementation();
+        for (style::scanner::Implementation implementation : SCANNER_IMPLEMENTATIONS) {
+            if (!style::scanner::useImplementation(implementation)) continue;
+            for (size_t length = 0; length < 100; length++) {
+                std::string text;
+                for (size_t i = 0; i < length; i++) {
+                    // mostly spaces so that the vectorized loops run over several chunks
+                    text += (generator() % 4) ? ' ' : alphabet[generator() % alphabet.size()];
+                }
+                for (size_t start = 0; start <= length + 1; start++) {
+                    for (char c : alphabet) {
+                        if (style::scanner::findCharacter(text, start, c) != style::scanner::scalar::findCharacter(text, start, c))
+                            testResult = test::Result::FAILURE;
+                    }
+                    if (style::scanner::skipBlanks(text, start) != style::scanner::scalar::skipBlanks(text, start))
+                        testResult = test::Result::FAILURE;
+                    if (style::scanner::findMultiLineCommentEnd(text, start) != style::scanner::scalar::findMultiLineCommentEnd(text, start))
+                        testResult = test::Result::FAILURE;
+                }
+            }
+        }
+        style::scanner::useImplementation(defaultImplementation);
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testLexingWithEachScanner() {
+        style::config::Config *config = testConfig();
+        const std::string padding = std::string(40, ' ') + "\t" + std::string(20, ' ');
+        const std::string expression = "/* a comment with * and / inside" + padding + "*/\n" + padding + "label {" + padding
+                                       + "// a one line comment" + padding + "\n    text: \"a long string with ' inside" + padding
+                                       + "\";\n    other: 'a long string with \" inside" + padding + "';" + padding + "\n}";
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if lexing\n'\n" << expression << "\n'\ngives the same tokens with every supported scanner implementation\n";
+        style::scanner::Implementation defaultImplementation = style::scanner::currentImplementation();
+        try {
+            style::scanner::useImplementation(style::scanner::Implementation::Scalar);
+            style::TokenStream expected = style::Lexer().lexeTokens(expression, config);
+            for (style::scanner::Implementation implementation : SCANNER_IMPLEMENTATIONS) {
+                if (!style::scanner::useImplementation(implementation)) continue;
+                style::TokenStream tokens = style::Lexer().lexeTokens(expression, config);
+                if (tokens.size() != expected.size()) testResult = test::Result::FAILURE;
+                for (size_t i = 0; i < tokens.size() && i < expected.size(); i++) {
+                    if (tokens[i].token != expected[i].token || tokens.value(tokens[i]) != expected.value(expected[i]))
+                        testResult = test::Result::FAILURE;
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        style::scanner::useImplementation(defaultImplementation);
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
     void testsLexer(test::Tests *tests) {
         tests->beginTestBlock("Tests lexer");
         tests->beginTestBlock("White spaces");
@@ -518,6 +944,25 @@ namespace testsLexer {
 
         tests->beginTestBlock("Multiple tokens");
         tests->addTest(testLexingImport, "Import");
+        tests->addTest(testLexingBoolFollowedByRawName, "Bool followed by raw name");
+        tests->addTest(testLexingNumbersAndUnits, "Numbers and units");
+        tests->addTest(testLexingLongestUnit, "Longest unit");
+        tests->addTest(testLexingNumberDiagnostics, "Number diagnostics");
+        tests->addTest(testLexingCommentsSkipped, "Comments skipped");
+        tests->addTest(testLexingCommentsKept, "Comments kept");
+        tests->addTest(testLexingWhiteSpacesFlags, "White spaces flags");
+        tests->addTest(testLexingPullMode, "Pull mode");
+        tests->addTest(testLexingInPlace, "Lexing in place");
+        tests->addTest(testLexingTokenStream, "Token stream");
+        tests->addTest(testCopiedTokenStreamOwningValues, "Copied token stream owning its values");
+        tests->addTest(testLexingStream, "Lexing by chunks");
+        tests->addTest(testLexingStreamWithReadCallback, "Lexing from a read callback");
+        tests->addTest(testLexingWithSameLexer, "Lexing with the same lexer");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("Scanners");
+        tests->addTest(testScannersMatchScalar, "Scanners match scalar");
+        tests->addTest(testLexingWithEachScanner, "Lexing with each scanner");
         tests->endTestBlock();
 
         tests->endTestBlock();
@@ -1,7 +1,13 @@
 #ifndef TESTS_LEXER_HPP
 #define TESTS_LEXER_HPP
 
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
 #include "../../cpp_tests/src/tests.hpp"
+#include "../../src/character_scanner.hpp"
 #include "../../src/lexer.hpp"
 #include "../test_config.hpp"
 
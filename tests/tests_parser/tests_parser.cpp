@@ -86,8 +86,8 @@ namespace testsParser {
         expected = expected->addChild(new style::DeserializationNode(style::Token::BlockDeclarations))
                        ->addChild(new style::DeserializationNode(style::Token::Assignment));
         expected->addChild(new style::DeserializationNode(style::Token::RuleName, "b"));
-        expected->addChild(new style::DeserializationNode(style::Token::Hex, "a"));
-        result = testLexerAndParser(true, "a {b: #a;}", rootExpected);
+        expected->addChild(new style::DeserializationNode(style::Token::Hex, "abc"));
+        result = testLexerAndParser(true, "a {b: #abc;}", rootExpected);
         delete rootExpected;
         return result;
     }
@@ -130,6 +130,34 @@ namespace testsParser {
         return result;
     }
 
+    test::Result testParsingHexRuleMalformed() { return testLexerAndParserException<style::MalformedExpressionException>("a {b: #abcd;}"); }
+
+    test::Result testParsingHexRuleNotHexadecimal() { return testLexerAndParserException<style::MalformedExpressionException>("a {b: #abcdeg;}"); }
+
+    test::Result testParsingHexRuleDecoded() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::pair<std::string, uint32_t>> colors = {{"#0000ff", 0x0000ffff}, {"#f80", 0xff8800ff}, {"#12345678", 0x12345678}};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if hexadecimal colors are decoded in packed rgba values\n";
+        for (const std::pair<std::string, uint32_t> &color : colors) {
+            const std::string expression = "a {b: " + color.first + ";}";
+            try {
+                style::DeserializationNode *result = style::Parser().parse(style::Lexer().lexeTokens(expression, config));
+                // NullRoot > StyleBlock > BlockDeclarations > Assignment > Hex
+                const style::DeserializationNode *hex = result->child()->child()->next()->child()->child()->next();
+                if (hex == nullptr || hex->token() != style::Token::Hex || hex->number().rgbaValue != color.second) testResult = test::Result::FAILURE;
+                delete result;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
     test::Result testParsingIntRule() {
         style::DeserializationNode *rootExpected;
         style::DeserializationNode *expected;
@@ -800,6 +828,386 @@ namespace testsParser {
         return result;
     }
 
+    test::Result testParsingTokenStream() {
+        style::config::Config *config = testConfig();
+        std::string fileContent = getFileContent(TESTS_FILES_DIR + "/test-1.txt");
+        test::Result testResult;
+        std::cout << "Test if parsing a token stream gives the same tree as parsing a chain of tokens\n";
+        try {
+            style::DeserializationNode *tokens = style::Lexer().lexe(fileContent, config);
+            style::DeserializationNode *expected = style::Parser().parse(tokens);
+            style::DeserializationNode *result = style::Parser().parse(style::Lexer().lexeTokens(fileContent, config));
+            if (areSameNodes(result, expected)) testResult = test::Result::SUCCESS;
+            else testResult = test::Result::FAILURE;
+            delete result;
+            delete expected;
+            delete tokens;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingWhiteSpacesFlags() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing tokens with white spaces flags gives the same tree as parsing white spaces tokens\n";
+        for (const std::string &fileName : fileNames) {
+            std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+            try {
+                style::DeserializationNode *expected = style::Parser().parse(style::Lexer().lexeTokens(fileContent, config));
+                style::DeserializationNode *result = style::Parser().parse(style::Lexer(false, false).lexeTokens(fileContent, config));
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                delete result;
+                delete expected;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingPullMode() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing in pull mode gives the same tree as parsing the whole token stream\n";
+        for (const std::string &fileName : fileNames) {
+            std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+            try {
+                style::DeserializationNode *expected = style::Parser().parse(style::Lexer().lexeTokens(fileContent, config));
+                style::DeserializationNode *result = style::Parser().parse(fileContent, config);
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                delete result;
+                delete expected;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingStream() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        const std::vector<size_t> chunkSizes = {1, 3, 16, DEFAULT_STREAM_CHUNK_SIZE};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing a stream read by chunks gives the same tree as parsing the whole token stream\n";
+        try {
+            style::config::CompiledConfig compiledConfig = style::config::CompiledConfig(config);
+            for (const std::string &fileName : fileNames) {
+                std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+                style::DeserializationNode *expected = style::Parser().parse(style::Lexer().lexeTokens(fileContent, config));
+                for (size_t chunkSize : chunkSizes) {
+                    std::istringstream input(fileContent);
+                    style::DeserializationNode *result = style::Parser().parse(input, &compiledConfig, chunkSize);
+                    if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                    delete result;
+                }
+                delete expected;
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingStreamAliveTokens() {
+        style::config::Config *config = testConfig();
+        const size_t blocksCount = 20000;
+        std::string expression;
+        for (size_t i = 0; i < blocksCount; i++) {
+            expression += "a.b > #c {\n    d: 10px;\n    e: \"some text\";\n    f: (1, 2, 3);\n}\n";
+        }
+        size_t position = 0;
+        size_t maxTokensCount = 0;
+        size_t maxValuesSize = 0;
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing a stream of " << expression.size() << " characters only keeps a few tokens alive : ";
+        try {
+            style::config::CompiledConfig compiledConfig = style::config::CompiledConfig(config);
+            style::Parser parser;
+            style::DeserializationNode *result = parser.parse(
+                [&](char *buffer, size_t size) {
+                    maxTokensCount = std::max(maxTokensCount, parser.pulledTokens().size());
+                    maxValuesSize = std::max(maxValuesSize, parser.pulledTokens().expression().size());
+                    size_t count = expression.copy(buffer, size, position);
+                    position += count;
+                    return count;
+                },
+                &compiledConfig, 64);
+            if (result->nbChilds() != blocksCount || maxTokensCount > 8 || maxValuesSize > 64) testResult = test::Result::FAILURE;
+            std::cout << "at most " << maxTokensCount << " tokens with " << maxValuesSize << " characters of values";
+            delete result;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingPullModeLexerException() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a {b: 1;}\nc {d: /* not closed }";
+        test::Result testResult;
+        std::cout << "Test if parsing\n'\n" << expression << "\n'\nin pull mode raises the lexer exception : ";
+        try {
+            delete style::Parser().parse(expression, config);
+            testResult = test::Result::FAILURE;
+        }
+        catch (const style::UnknownValue &) {
+            testResult = test::Result::SUCCESS;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingPullModeLexerExceptionAfterParserError() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> expressions = {"(/", "a {b:;}\nc {d: /* not closed }"};
+        const std::string parserErrorExpression = "a {b:;}\nc {d: 1;}";
+        style::Parser parser;
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing in pull mode an expression with a parser error before a lexer error raises the lexer exception : ";
+        try {
+            style::config::CompiledConfig compiledConfig = style::config::CompiledConfig(config);
+            for (const std::string &expression : expressions) {
+                for (int i = 0; i < 2; i++) {
+                    try {
+                        std::istringstream input(expression);
+                        if (i == 0) delete parser.parse(expression, config);
+                        else delete parser.parse(input, &compiledConfig, 1);
+                        testResult = test::Result::FAILURE;
+                    }
+                    catch (const style::UnknownValue &) {
+                    }
+                }
+            }
+            // without a lexer error, the parser error is kept
+            try {
+                delete parser.parse(parserErrorExpression, config);
+                testResult = test::Result::FAILURE;
+            }
+            catch (const style::MalformedExpressionException &) {
+            }
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingInParallel() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing in parallel gives the same tree as parsing serially\n";
+        for (const std::string &fileName : fileNames) {
+            std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+            try {
+                style::DeserializationNode *expected = style::Parser().parse(fileContent, config);
+                // one chunk per block
+                style::DeserializationNode *result = style::ParallelParser(4, 1).parse(fileContent, config);
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                delete result;
+                delete expected;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParallelSplitPoints() {
+        style::config::Config *config = testConfig();
+        const std::string expression = "a {b: 1;}\nc {d: '}\n';}\n/* }\n */e {f {}\n}\n// }\ng {}";
+        const std::vector<size_t> expectedPoints = {9, 22, 40, expression.size()};
+        std::cout << "Test if\n'\n" << expression << "\n'\nis only split after top level closing curly brackets\n";
+        std::vector<size_t> points = style::ParallelParser::splitPoints(expression, config, 1);
+        delete config;
+        std::cout << "\n";
+        return (points == expectedPoints) ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testParsingInParallelException() {
+        style::config::Config *config = testConfig();
+        // the chunks after the first invalid one can raise an other exception
+        const std::string expression = "a {b: 1;}\nc {d: 1}\ne {f: 1;}\ng {h: 1 2;}";
+        test::Result testResult;
+        std::cout << "Test if parsing\n'\n" << expression << "\n'\nin parallel raises the same exception as parsing serially : ";
+        try {
+            delete style::ParallelParser(4, 1).parse(expression, config);
+            testResult = test::Result::FAILURE;
+        }
+        catch (const style::MissingTokenException &) {
+            testResult = test::Result::SUCCESS;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingInArena() {
+        style::config::Config *config = testConfig();
+        std::string fileContent = getFileContent(TESTS_FILES_DIR + "/test-1.txt");
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if parsing in an arena gives the same tree as parsing on the heap\n";
+        try {
+            style::DeserializationNode *tokens = style::Lexer().lexe(fileContent, config);
+            style::DeserializationNode *expected = style::Parser().parse(tokens);
+            style::NodeArena arena;
+            {
+                style::NodeArena::Scope arenaScope(&arena);
+                style::DeserializationNode *result = style::Parser().parse(tokens);
+                // NullRoot > StyleBlock > BlockSelectors > Selector > first component, whose value is copied in the arena
+                if (!areSameNodes(result, expected) || !result->child()->child()->child()->child()->borrowsValue())
+                    testResult = test::Result::FAILURE;
+                delete result;
+                result = style::Parser().parse(fileContent, config);
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+            }
+            // the trees of the arena are released without being deleted
+            arena.release();
+            delete expected;
+            delete tokens;
+        }
+        catch (const std::exception &e) {
+            testResult = test::Result::ERROR;
+            std::cerr << "Failed with error : " << e.what();
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingWithSameParser() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        test::Result testResult = test::Result::SUCCESS;
+        style::Parser parser;
+        std::cout << "Test if parsing with a parser already used, even by a failed parsing, gives the same tree as with a new parser\n";
+        for (const std::string &fileName : fileNames) {
+            std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+            try {
+                style::DeserializationNode *expected = style::Parser().parse(fileContent, config);
+                try {
+                    delete parser.parse("a {b: 1;}\nc {d: 1}", config);
+                    testResult = test::Result::FAILURE;
+                }
+                catch (const style::ParserException &) {
+                }
+                style::DeserializationNode *result = parser.parse(fileContent, config);
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                delete result;
+                result = parser.parseFlat(fileContent, config).toNodes();
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                delete result;
+                delete expected;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testParsingFlatTree() {
+        style::config::Config *config = testConfig();
+        const std::vector<std::string> fileNames = {"test-1.txt", "test-2.txt", "test-3.txt", "test-4.txt", "test-5.txt", "test-7.txt"};
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if the flat tree has the nodes of the parsed tree in preorder\n";
+        for (const std::string &fileName : fileNames) {
+            std::string fileContent = getFileContent(TESTS_FILES_DIR + "/" + fileName);
+            try {
+                style::FlatTree flatTree = style::Parser().parseFlat(fileContent, config);
+                style::DeserializationNode *expected = style::Parser().parse(fileContent, config);
+                style::DeserializationNode *result = flatTree.toNodes();
+                if (!areSameNodes(result, expected)) testResult = test::Result::FAILURE;
+                for (uint32_t i = 1; i < flatTree.size(); i++) {
+                    if (flatTree.parent(i) >= i) testResult = test::Result::FAILURE;
+                    if (flatTree.firstChild(i) != style::FlatTree::NO_NODE && flatTree.firstChild(i) != i + 1) testResult = test::Result::FAILURE;
+                    if (flatTree.nextSibling(i) == style::FlatTree::NO_NODE && flatTree.lastChild(flatTree.parent(i)) != i)
+                        testResult = test::Result::FAILURE;
+                }
+                delete result;
+                delete expected;
+            }
+            catch (const std::exception &e) {
+                testResult = test::Result::ERROR;
+                std::cerr << "Failed with error : " << e.what();
+            }
+        }
+        delete config;
+        std::cout << "\n";
+        return testResult;
+    }
+
+    test::Result testDetachingNodes() {
+        test::Result testResult = test::Result::SUCCESS;
+        std::cout << "Test if detached nodes keep their childs and are moved without being copied\n";
+        style::DeserializationNode *root = new style::DeserializationNode(style::Token::NullRoot);
+        style::DeserializationNode *first = root->addChild(new style::DeserializationNode(style::Token::Name, "a"));
+        style::DeserializationNode *tuple = root->addChild(new style::DeserializationNode(style::Token::Tuple));
+        style::DeserializationNode *last = root->addChild(new style::DeserializationNode(style::Token::Name, "b"));
+        style::DeserializationNode *value = tuple->addChild(new style::DeserializationNode(style::Token::Int, "1"));
+        tuple->addChild(new style::DeserializationNode(style::Token::Int, "2"));
+
+        if (root->detachChild(tuple) != tuple || tuple->parent() != nullptr || root->nbChilds() != 2 || first->next() != last) {
+            testResult = test::Result::FAILURE;
+        }
+        last->addChild(tuple);
+        if (tuple->parent() != last || tuple->child() != value || tuple->nbChilds() != 2) testResult = test::Result::FAILURE;
+        // the tuple and its childs are moved in the first node, the tuple node itself and the nexts of the first one being deleted
+        last->detachChild(tuple);
+        first->replaceData(tuple);
+        if (first->token() != style::Token::Tuple || first->child() != value || value->parent() != first || root->getLastChild() != first
+            || root->nbChilds() != 1) {
+            testResult = test::Result::FAILURE;
+        }
+        delete root;
+        std::cout << "\n";
+        return testResult;
+    }
+
     test::Result testMultilineCommentNotClosed() {
         std::string fileContent;
 
@@ -816,6 +1224,9 @@ namespace testsParser {
         tests->addTest(testParsingHexRule, "Hex rule");
         tests->addTest(testParsingHexRuleMultipleChars, "Hex rule multiple chars");
         tests->addTest(testParsingHexRuleOnlyInts, "Hex rule only ints");
+        tests->addTest(testParsingHexRuleMalformed, "Hex rule malformed");
+        tests->addTest(testParsingHexRuleNotHexadecimal, "Hex rule not hexadecimal");
+        tests->addTest(testParsingHexRuleDecoded, "Hex rule decoded");
         tests->addTest(testParsingIntRule, "Int rule");
         tests->addTest(testParsingIntRuleMultipleChars, "Int rule multiple chars");
         tests->addTest(testParsingEmptyTuple, "Empty tuple");
@@ -876,6 +1287,20 @@ namespace testsParser {
                        "Apply style block to any child component with nested element name");
         tests->addTest(testValuesUnits, "Values units");
         tests->addTest(testMultilineCommentNotClosed, "Multiline comment not closed");
+        tests->addTest(testParsingTokenStream, "Token stream");
+        tests->addTest(testParsingWhiteSpacesFlags, "White spaces flags");
+        tests->addTest(testParsingPullMode, "Pull mode");
+        tests->addTest(testParsingPullModeLexerException, "Pull mode lexer exception");
+        tests->addTest(testParsingPullModeLexerExceptionAfterParserError, "Pull mode lexer exception after a parser error");
+        tests->addTest(testParsingStream, "Stream");
+        tests->addTest(testParsingStreamAliveTokens, "Stream alive tokens");
+        tests->addTest(testParsingInParallel, "Parallel parsing");
+        tests->addTest(testParallelSplitPoints, "Parallel parsing split points");
+        tests->addTest(testParsingInParallelException, "Parallel parsing exception");
+        tests->addTest(testParsingInArena, "Arena");
+        tests->addTest(testParsingFlatTree, "Flat tree");
+        tests->addTest(testParsingWithSameParser, "Parsing with the same parser");
+        tests->addTest(testDetachingNodes, "Detaching nodes");
         tests->endTestBlock();
     }
 
@@ -11,6 +11,7 @@
 #include "../../cpp_tests/src/tests.hpp"
 #include "../../src/lexer.hpp"
 #include "../../src/deserialization_node.hpp"
+#include "../../src/parallel_parser.hpp"
 #include "../../src/parser.hpp"
 #include "../test_config.hpp"
 